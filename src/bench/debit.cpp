@@ -0,0 +1,380 @@
+/**
+ * \file debit.cpp
+ * \brief Mesure du débit des simulations et comparaison avec une
+ *        mesure de référence.
+ *
+ * Les simulations sont celles de la recherche de
+ * ia::JoueurIntelligent, avec ses paramètres par défaut. Elles
+ * partent du goban vide et de positions de milieu de partie lues
+ * dans res/bench/positions.txt, sur les gobans de 9 et de 19, avec
+ * un seul thread puis avec le nombre de threads demandé, quatre
+ * par défaut quel que soit le nombre de cœurs, afin que la
+ * référence ait les mêmes mesures sur toutes les machines ; chaque
+ * thread a son propre moteur de simulation.
+ *
+ * Chaque mesure est répétée, les répétitions faisant le tour des
+ * mesures, et la meilleure répétition est retenue : une machine
+ * chargée ne peut que ralentir les simulations. L'écart entre la
+ * meilleure et la moins bonne répétition est donné comme
+ * dispersion.
+ *
+ * Le résultat est écrit au format JSON sur la sortie standard. Si
+ * un fichier de référence produit de la même façon est donné,
+ * chaque mesure est comparée à celle de même taille, de même
+ * position et de même nombre de threads, et le programme échoue
+ * si l'une d'elles a baissé de plus du seuil, en pourcentage. Le
+ * seuil par défaut est au-dessus des écarts observés entre deux
+ * exécutions sur une même machine.
+ *
+ * Usage : debit [reference [seuil [threads [duree [repetitions]]]]]
+ */
+
+#include <cstdio> // std::printf, std::fprintf
+#include <cstdlib> // std::atoi, std::atof
+
+#include <algorithm> // std::max, std::min
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono
+#include <fstream> // std::ifstream
+#include <list> // std::list
+#include <sstream> // std::istringstream, std::ostringstream
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/generateur.hpp>
+
+#include <ia/recherche.hpp>
+#include <ia/playout.hpp>
+
+namespace {
+
+    /**
+     * \brief Fichier des positions de milieu de partie.
+     */
+    const char* const POSITIONS = "res/bench/positions.txt";
+
+    /**
+     * \brief Position de départ des simulations.
+     */
+    struct Position {
+	jeu::EtatGoban etat;
+	bool tourNoir;
+	jeu::Coup dernierCoup;
+    };
+
+    /**
+     * \brief Résultat d'une mesure.
+     */
+    struct Mesure {
+	int taille;
+	std::string position;
+	int threads;
+
+	/**
+	 * \brief Simulations par seconde de la meilleure répétition.
+	 */
+	double debit;
+
+	/**
+	 * \brief Écart relatif entre la meilleure et la moins bonne
+	 *        répétition, en pourcentage.
+	 */
+	double dispersion;
+    };
+
+    /**
+     * \brief Lecture d'un coup noté comme pour jeu::JoueurTexte.
+     */
+    bool
+    lireCoup(const std::string& mot, int taille, jeu::Coup& coup)
+    {
+	if (mot == "p") {
+	    coup = jeu::Coup();
+	    coup.type = jeu::TC_PASSER;
+	    return true;
+	}
+	std::istringstream flux(mot);
+	char c;
+	int i;
+	char reste;
+	if (!(flux >> c >> i) || (flux >> reste) ||
+	    c < 'A' || c - 'A' >= taille || i < 1 || i > taille) {
+	    return false;
+	}
+	coup = jeu::Coup(jeu::Intersection(i - 1, c - 'A'));
+	return true;
+    }
+
+    /**
+     * \brief Lecture des positions de milieu de partie d'une taille
+     *        de goban.
+     */
+    bool
+    lirePositions(const jeu::Goban& goban, std::vector<Position>& positions)
+    {
+	std::ifstream fichier(POSITIONS);
+	if (!fichier) {
+	    return false;
+	}
+	std::string ligne;
+	while (std::getline(fichier, ligne)) {
+	    std::istringstream flux(ligne);
+	    int taille;
+	    if (ligne.empty() || ligne[0] == '#' || !(flux >> taille) ||
+		taille != goban.taille()) {
+		continue;
+	    }
+	    Position position;
+	    position.etat = jeu::EtatGoban(goban);
+	    position.tourNoir = true;
+	    std::string mot;
+	    while (flux >> mot) {
+		jeu::Coup coup;
+		if (!lireCoup(mot, taille, coup) ||
+		    (coup.type == jeu::TC_POSER &&
+		     !position.etat.poser(coup.intersection, position.tourNoir))) {
+		    return false;
+		}
+		if (coup.type == jeu::TC_PASSER) {
+		    position.etat.passer();
+		}
+		position.dernierCoup = coup;
+		position.tourNoir = !position.tourNoir;
+	    }
+	    positions.push_back(position);
+	}
+	return !positions.empty();
+    }
+
+    /**
+     * \brief Boucle d'un thread : simulations depuis les positions
+     *        à tour de rôle, jusqu'à la fin de la mesure.
+     */
+    void
+    simuler(const std::vector<Position>& positions, uint64_t graine,
+	    std::chrono::steady_clock::time_point fin,
+	    std::atomic<long>& nbSimulations)
+    {
+	jeu::Generateur generateur(graine);
+	ia::Playout playout(generateur);
+	playout.heuristiques(ia::Parametres().heuristiques);
+	long n = 0;
+	while (std::chrono::steady_clock::now() < fin) {
+	    const Position& position = positions[n % positions.size()];
+	    playout.jouer(position.etat, position.tourNoir,
+			  position.dernierCoup);
+	    ++n;
+	}
+	nbSimulations += n;
+    }
+
+    /**
+     * \brief Nombre de simulations par seconde depuis des
+     *        positions, avec un nombre de threads donné.
+     */
+    double
+    mesurer(const std::vector<Position>& positions, int nbThreads,
+	    double duree)
+    {
+	std::atomic<long> nbSimulations(0);
+	std::chrono::steady_clock::time_point debut =
+	    std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point fin = debut
+	    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(duree));
+	std::vector<std::thread> threads;
+	for (int t = 0; t < nbThreads; ++t) {
+	    threads.push_back(std::thread(simuler, std::cref(positions),
+					  (uint64_t) t + 1, fin,
+					  std::ref(nbSimulations)));
+	}
+	for (int t = 0; t < nbThreads; ++t) {
+	    threads[t].join();
+	}
+	std::chrono::duration<double> ecoule =
+	    std::chrono::steady_clock::now() - debut;
+	return nbSimulations / ecoule.count();
+    }
+
+    /**
+     * \brief Valeur d'un champ d'un objet JSON sans objet imbriqué,
+     *        guillemets ôtés.
+     */
+    std::string
+    champ(const std::string& objet, const std::string& nom)
+    {
+	std::string::size_type debut = objet.find("\"" + nom + "\"");
+	if (debut == std::string::npos) {
+	    return "";
+	}
+	debut = objet.find(':', debut);
+	if (debut == std::string::npos) {
+	    return "";
+	}
+	std::string::size_type fin = objet.find_first_of(",}", debut);
+	std::string valeur = objet.substr(debut + 1, fin - debut - 1);
+	std::string resultat;
+	for (std::string::size_type n = 0; n < valeur.size(); ++n) {
+	    if (valeur[n] != ' ' && valeur[n] != '"' && valeur[n] != '\n') {
+		resultat += valeur[n];
+	    }
+	}
+	return resultat;
+    }
+
+    /**
+     * \brief Lecture des mesures d'un fichier écrit par ce
+     *        programme.
+     */
+    bool
+    lireReference(const std::string& nom, std::vector<Mesure>& mesures)
+    {
+	std::ifstream fichier(nom.c_str());
+	if (!fichier) {
+	    return false;
+	}
+	std::ostringstream contenu;
+	contenu << fichier.rdbuf();
+	std::string texte = contenu.str();
+
+	std::string::size_type debut = texte.find('[');
+	while (debut != std::string::npos &&
+	       (debut = texte.find('{', debut)) != std::string::npos) {
+	    std::string::size_type fin = texte.find('}', debut);
+	    if (fin == std::string::npos) {
+		return false;
+	    }
+	    std::string objet = texte.substr(debut, fin - debut + 1);
+	    Mesure mesure;
+	    mesure.taille = std::atoi(champ(objet, "taille").c_str());
+	    mesure.position = champ(objet, "position");
+	    mesure.threads = std::atoi(champ(objet, "threads").c_str());
+	    mesure.debit = std::atof(champ(objet, "simulations_par_seconde").c_str());
+	    mesure.dispersion = std::atof(champ(objet, "dispersion").c_str());
+	    if (mesure.taille <= 0 || mesure.threads <= 0 || mesure.debit <= 0) {
+		return false;
+	    }
+	    mesures.push_back(mesure);
+	    debut = fin;
+	}
+	return true;
+    }
+
+}
+
+int
+main(int argc, char** argv)
+{
+    std::string nomReference = argc > 1 ? argv[1] : "";
+    double seuil = argc > 2 ? std::atof(argv[2]) : 35;
+    int nbThreadsMax = argc > 3 ? std::atoi(argv[3]) : 4;
+    double duree = argc > 4 ? std::atof(argv[4]) : 2;
+    int nbRepetitions = argc > 5 ? std::atoi(argv[5]) : 5;
+    if (nbThreadsMax < 1) {
+	nbThreadsMax = 1;
+    }
+    if (nbRepetitions < 1) {
+	nbRepetitions = 1;
+    }
+
+    std::vector<Mesure> reference;
+    if (!nomReference.empty() && !lireReference(nomReference, reference)) {
+	std::fprintf(stderr, "référence illisible : %s\n",
+		     nomReference.c_str());
+	return 1;
+    }
+
+    // les gobans doivent survivre aux positions qui les désignent
+    const int tailles[] = {9, 19};
+    jeu::Gobans gobans;
+    std::list<std::vector<Position> > listes;
+    std::vector<Mesure> mesures;
+    std::vector<const std::vector<Position>*> positions;
+    for (int t = 0; t < 2; ++t) {
+	const jeu::Goban& goban = gobans.goban(tailles[t]);
+
+	listes.push_back(std::vector<Position>(1));
+	std::vector<Position>& vide = listes.back();
+	vide[0].etat = jeu::EtatGoban(goban);
+	vide[0].tourNoir = true;
+	listes.push_back(std::vector<Position>());
+	std::vector<Position>& milieux = listes.back();
+	if (!lirePositions(goban, milieux)) {
+	    std::fprintf(stderr, "positions illisibles : %s\n", POSITIONS);
+	    return 1;
+	}
+
+	for (int p = 0; p < 2; ++p) {
+	    for (int n = 1; n <= nbThreadsMax; n = n < nbThreadsMax
+		     ? nbThreadsMax : n + 1) {
+		Mesure mesure;
+		mesure.taille = tailles[t];
+		mesure.position = p == 0 ? "vide" : "milieu";
+		mesure.threads = n;
+		mesure.debit = 0;
+		mesure.dispersion = 0;
+		mesures.push_back(mesure);
+		positions.push_back(p == 0 ? &vide : &milieux);
+	    }
+	}
+    }
+
+    // les répétitions font le tour des mesures, afin qu'un
+    // ralentissement passager de la machine ne touche pas toutes
+    // celles d'une même mesure
+    std::vector<double> minimums(mesures.size(), 0);
+    for (int r = 0; r < nbRepetitions; ++r) {
+	for (unsigned int m = 0; m < mesures.size(); ++m) {
+	    double debit = mesurer(*positions[m], mesures[m].threads, duree);
+	    mesures[m].debit = std::max(mesures[m].debit, debit);
+	    minimums[m] = r == 0 ? debit : std::min(minimums[m], debit);
+	}
+    }
+    for (unsigned int m = 0; m < mesures.size(); ++m) {
+	mesures[m].dispersion = 100 * (1 - minimums[m] / mesures[m].debit);
+    }
+
+    std::printf("{\n  \"duree\": %.1f,\n  \"repetitions\": %d,\n"
+		"  \"mesures\": [\n", duree, nbRepetitions);
+    for (unsigned int m = 0; m < mesures.size(); ++m) {
+	std::printf("    {\"taille\": %d, \"position\": \"%s\", "
+		    "\"threads\": %d, \"simulations_par_seconde\": %.0f, "
+		    "\"dispersion\": %.1f}%s\n",
+		    mesures[m].taille, mesures[m].position.c_str(),
+		    mesures[m].threads, mesures[m].debit,
+		    mesures[m].dispersion,
+		    m + 1 < mesures.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+
+    // les mesures sans équivalent dans la référence ne sont pas
+    // comparées
+    bool regression = false;
+    for (unsigned int m = 0; m < mesures.size(); ++m) {
+	for (unsigned int r = 0; r < reference.size(); ++r) {
+	    if (reference[r].taille != mesures[m].taille ||
+		reference[r].position != mesures[m].position ||
+		reference[r].threads != mesures[m].threads) {
+		continue;
+	    }
+	    double ecart = 100 * (mesures[m].debit / reference[r].debit - 1);
+	    bool baisse = ecart < -seuil;
+	    std::fprintf(stderr, "%s%dx%d %s, %d threads : %.0f/s contre %.0f/s "
+			 "(%+.1f %%)\n", baisse ? "RÉGRESSION " : "",
+			 mesures[m].taille, mesures[m].taille,
+			 mesures[m].position.c_str(), mesures[m].threads,
+			 mesures[m].debit, reference[r].debit, ecart);
+	    regression = regression || baisse;
+	}
+    }
+    if (regression) {
+	std::fprintf(stderr, "baisse du débit de plus de %.1f %% "
+		     "par rapport à %s\n", seuil, nomReference.c_str());
+	return 1;
+    }
+    return 0;
+}
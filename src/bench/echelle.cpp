@@ -0,0 +1,68 @@
+/**
+ * \file echelle.cpp
+ * \brief Mesure du passage à l'échelle de la recherche
+ *        multi-thread.
+ *
+ * Pour chaque nombre de threads de 1 à N, une recherche est
+ * lancée depuis le goban vide et le nombre de simulations par
+ * seconde est affiché, avec l'accélération et l'efficacité par
+ * rapport à un seul thread.
+ *
+ * Usage : echelle [taille [simulations [threads]]]
+ */
+
+#include <cstdio> // std::printf
+#include <cstdlib> // std::atoi
+
+#include <chrono> // std::chrono
+#include <thread> // std::thread
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/generateur.hpp>
+
+#include <ia/recherche.hpp>
+
+int
+main(int argc, char** argv)
+{
+    int taille = argc > 1 ? std::atoi(argv[1]) : 9;
+    int nbSimulations = argc > 2 ? std::atoi(argv[2]) : 20000;
+    int nbThreadsMax = argc > 3 ? std::atoi(argv[3])
+	: (int) std::thread::hardware_concurrency();
+    if (nbThreadsMax < 1) {
+	nbThreadsMax = 1;
+    }
+
+    jeu::Goban goban(taille);
+    jeu::EtatGoban etat(goban);
+
+    std::printf("# goban %dx%d, %d simulations\n",
+		taille, taille, nbSimulations);
+    std::printf("# threads simulations/s acceleration efficacite\n");
+
+    double reference = 0;
+    for (int t = 1; t <= nbThreadsMax; ++t) {
+	ia::Parametres parametres;
+	parametres.nbThreads = t;
+	jeu::Generateur generateur(t);
+	ia::Recherche recherche(parametres, generateur);
+	recherche.initialiser(etat, true, jeu::Coup());
+
+	std::chrono::steady_clock::time_point debut =
+	    std::chrono::steady_clock::now();
+	recherche.simuler(nbSimulations);
+	std::chrono::duration<double> duree =
+	    std::chrono::steady_clock::now() - debut;
+
+	double debit = nbSimulations / duree.count();
+	if (t == 1) {
+	    reference = debit;
+	}
+	std::printf("%d %.0f %.2f %.2f\n", t, debit,
+		    debit / reference, debit / reference / t);
+    }
+
+    return 0;
+}
@@ -0,0 +1,483 @@
+/**
+ * \file regles.cpp
+ * \brief Micro-mesures des opérations du moteur de règles.
+ *
+ * Chaque mesure porte sur des positions tirées par des parties
+ * aléatoires à graine fixe, identiques d'une exécution à l'autre,
+ * pour les gobans de 9, 13 et 19. Une ligne est affichée par
+ * mesure et par taille : le nom de l'opération, la taille, le temps
+ * moyen par opération en nanosecondes, le nombre moyen
+ * d'allocations par opération et le nombre d'opérations mesurées.
+ *
+ * Les copies d'états nécessaires aux opérations qui les modifient
+ * sont faites par lots, hors du temps mesuré.
+ *
+ * Usage : regles [duree par mesure en secondes]
+ */
+
+#include <cstdio> // std::printf
+#include <cstdlib> // std::atof, std::malloc, std::free
+#include <new> // std::bad_alloc
+
+#include <chrono> // std::chrono
+#include <vector> // std::vector
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/generateur.hpp>
+#include <jeu/joueur.hpp>
+#include <jeu/partie.hpp>
+
+namespace {
+
+    /**
+     * \brief Nombre d'allocations depuis le début du programme.
+     */
+    long nbAllocations = 0;
+
+}
+
+void*
+operator new(std::size_t taille)
+{
+    ++nbAllocations;
+    void* p = std::malloc(taille > 0 ? taille : 1);
+    if (p == NULL) {
+	throw std::bad_alloc();
+    }
+    return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+    /**
+     * \brief Nombre de positions de départ par taille de goban.
+     */
+    const int NB_POSITIONS = 64;
+
+    /**
+     * \brief Nombre d'états préparés par lot.
+     */
+    const int TAILLE_LOT = 256;
+
+    /**
+     * \brief Durée minimale de chaque mesure, en secondes.
+     */
+    double dureeMesure = 0.2;
+
+    /**
+     * \brief Valeur accumulée à partir des résultats, afin que le
+     *        compilateur ne supprime pas les opérations mesurées.
+     */
+    volatile long puits = 0;
+
+    /**
+     * \brief Mesure d'une opération répétée par lots.
+     *
+     * preparer() met en place un lot hors du temps mesuré, puis
+     * operer() exécute les opérations du lot et retourne leur
+     * nombre. Les lots sont répétés jusqu'à atteindre la durée de
+     * mesure.
+     */
+    class Mesure {
+
+    public:
+
+	virtual
+	~Mesure()
+	{
+	}
+
+	virtual
+	void
+	preparer(int lot)
+	{
+	    (void) lot;
+	}
+
+	virtual
+	long
+	operer(int lot) = 0;
+
+	void
+	executer(const char* nom, int taille)
+	{
+	    typedef std::chrono::steady_clock Horloge;
+	    double secondes = 0;
+	    long allocations = 0;
+	    long nbOperations = 0;
+	    for (int lot = 0; secondes < dureeMesure; ++lot) {
+		preparer(lot);
+		long allocationsAvant = nbAllocations;
+		Horloge::time_point debut = Horloge::now();
+		nbOperations += operer(lot);
+		std::chrono::duration<double> duree = Horloge::now() - debut;
+		allocations += nbAllocations - allocationsAvant;
+		secondes += duree.count();
+	    }
+	    std::printf("%s %d %.1f %.3f %ld\n", nom, taille,
+			1e9 * secondes / nbOperations,
+			(double) allocations / nbOperations, nbOperations);
+	}
+
+    };
+
+    /**
+     * \brief Positions de départ et coups de test d'une taille de
+     *        goban.
+     */
+    struct Positions {
+
+	/**
+	 * \brief Positions en milieu de partie.
+	 */
+	std::vector<jeu::EtatGoban> milieux;
+
+	/**
+	 * \brief Coup licite de noir pour chaque position.
+	 */
+	std::vector<jeu::Intersection> coups;
+
+	/**
+	 * \brief Pierre présente sur chaque position.
+	 */
+	std::vector<jeu::Intersection> pierres;
+
+	/**
+	 * \brief Positions en fin de partie, après deux passes.
+	 */
+	std::vector<jeu::EtatGoban> fins;
+
+	Positions(const jeu::Goban& goban)
+	{
+	    int taille = goban.taille();
+	    for (int p = 0; p < NB_POSITIONS; ++p) {
+		jeu::Generateur generateur(1000 * taille + p);
+		jeu::EtatGoban etat(goban);
+		bool noir = true;
+		int nbPasses = 0;
+		int nbCoups = 0;
+		while (nbPasses < 2 && nbCoups < 3 * taille * taille) {
+		    if (nbCoups == taille * taille / 2) {
+			milieux.push_back(etat);
+			noir = true;
+		    }
+		    jeu::Coup coup = etat.coupAleatoire(noir, generateur, true);
+		    if (coup.type == jeu::TC_POSER) {
+			etat.poser(coup.intersection, noir);
+			nbPasses = 0;
+		    }
+		    else {
+			etat.passer();
+			++nbPasses;
+		    }
+		    noir = !noir;
+		    ++nbCoups;
+		}
+		fins.push_back(etat);
+	    }
+
+	    for (int p = 0; p < NB_POSITIONS; ++p) {
+		jeu::Generateur generateur(2000 * taille + p);
+		jeu::EtatGoban& etat = milieux[p];
+		coups.push_back(etat.coupAleatoire(true, generateur).intersection);
+		jeu::Intersection pierre;
+		do {
+		    pierre.i = generateur.entier(taille);
+		    pierre.j = generateur.entier(taille);
+		} while (etat.etat(pierre) != jeu::EI_NOIR &&
+			 etat.etat(pierre) != jeu::EI_BLANC);
+		pierres.push_back(pierre);
+	    }
+	}
+
+    };
+
+    /**
+     * \brief Pose d'une pierre sur une copie d'une position.
+     */
+    class MesurePoser : public Mesure {
+
+    public:
+
+	MesurePoser(const Positions& positions)
+	    : positions_(positions),
+	      etats_(TAILLE_LOT, positions.milieux[0])
+	{
+	}
+
+	virtual
+	void
+	preparer(int lot)
+	{
+	    for (int e = 0; e < TAILLE_LOT; ++e) {
+		etats_[e] = positions_.milieux[(lot + e) % NB_POSITIONS];
+	    }
+	}
+
+	virtual
+	long
+	operer(int lot)
+	{
+	    for (int e = 0; e < TAILLE_LOT; ++e) {
+		puits += etats_[e].poser(
+		    positions_.coups[(lot + e) % NB_POSITIONS], true);
+	    }
+	    return TAILLE_LOT;
+	}
+
+    protected:
+
+	const Positions& positions_;
+
+	std::vector<jeu::EtatGoban> etats_;
+
+    };
+
+    /**
+     * \brief Test de mort de toutes les pierres d'une position.
+     */
+    class MesureMort : public Mesure {
+
+    public:
+
+	MesureMort(const Positions& positions)
+	    : positions_(positions)
+	{
+	}
+
+	virtual
+	long
+	operer(int lot)
+	{
+	    const jeu::EtatGoban& etat = positions_.milieux[lot % NB_POSITIONS];
+	    int taille = etat.goban().taille();
+	    long nbOperations = 0;
+	    jeu::Intersection inter;
+	    for (inter.i = 0; inter.i < taille; ++inter.i) {
+		for (inter.j = 0; inter.j < taille; ++inter.j) {
+		    if (etat.etat(inter) == jeu::EI_NOIR ||
+			etat.etat(inter) == jeu::EI_BLANC) {
+			puits += etat.mort(inter);
+			++nbOperations;
+		    }
+		}
+	    }
+	    return nbOperations;
+	}
+
+    private:
+
+	const Positions& positions_;
+
+    };
+
+    /**
+     * \brief Retrait d'une chaîne d'une copie d'une position.
+     */
+    class MesureTuer : public MesurePoser {
+
+    public:
+
+	MesureTuer(const Positions& positions)
+	    : MesurePoser(positions)
+	{
+	}
+
+	virtual
+	long
+	operer(int lot)
+	{
+	    for (int e = 0; e < TAILLE_LOT; ++e) {
+		etats_[e].tuer(positions_.pierres[(lot + e) % NB_POSITIONS]);
+	    }
+	    return TAILLE_LOT;
+	}
+
+    };
+
+    /**
+     * \brief Décompte des points d'une copie d'une position finale.
+     */
+    class MesureFinir : public Mesure {
+
+    public:
+
+	MesureFinir(const Positions& positions)
+	    : positions_(positions),
+	      etats_(TAILLE_LOT, positions.fins[0])
+	{
+	}
+
+	virtual
+	void
+	preparer(int lot)
+	{
+	    for (int e = 0; e < TAILLE_LOT; ++e) {
+		etats_[e] = positions_.fins[(lot + e) % NB_POSITIONS];
+	    }
+	}
+
+	virtual
+	long
+	operer(int lot)
+	{
+	    (void) lot;
+	    for (int e = 0; e < TAILLE_LOT; ++e) {
+		etats_[e].finir();
+		puits += etats_[e].score().noir;
+	    }
+	    return TAILLE_LOT;
+	}
+
+    private:
+
+	const Positions& positions_;
+
+	std::vector<jeu::EtatGoban> etats_;
+
+    };
+
+    /**
+     * \brief Construction d'un état par copie.
+     */
+    class MesureCopie : public Mesure {
+
+    public:
+
+	MesureCopie(const Positions& positions)
+	    : positions_(positions)
+	{
+	}
+
+	virtual
+	long
+	operer(int lot)
+	{
+	    for (int e = 0; e < TAILLE_LOT; ++e) {
+		jeu::EtatGoban copie(positions_.milieux[(lot + e) % NB_POSITIONS]);
+		puits += copie.nbVides();
+	    }
+	    return TAILLE_LOT;
+	}
+
+    private:
+
+	const Positions& positions_;
+
+    };
+
+    /**
+     * \brief Pose d'une pierre dans une partie dont l'historique
+     *        est long, superko compris.
+     *
+     * Chaque lot rejoue hors mesure la première moitié d'une longue
+     * partie aléatoire, puis mesure les coups de la seconde
+     * moitié.
+     */
+    class MesurePartie : public Mesure {
+
+    public:
+
+	MesurePartie(const jeu::Goban& goban)
+	    : goban_(goban),
+	      coups_(),
+	      partie_(NULL)
+	{
+	    // la partie est jouée dans une Partie pour que tous les
+	    // coups retenus respectent le superko
+	    jeu::Generateur generateur(3000 * goban.taille());
+	    jeu::Partie partie(goban, spectateur_, spectateur_);
+	    int nbCoupsMax = 3 * goban.taille() * goban.taille();
+	    while (!partie.finie() && (int) coups_.size() < nbCoupsMax) {
+		jeu::Coup coup = partie.etatCourant().coupAleatoire(
+		    partie.tourNoir(), generateur, true);
+		if (!partie.jouer(coup)) {
+		    coup = jeu::Coup();
+		    coup.type = jeu::TC_PASSER;
+		    partie.jouer(coup);
+		}
+		coups_.push_back(coup);
+	    }
+	}
+
+	virtual
+	~MesurePartie()
+	{
+	    delete partie_;
+	}
+
+	virtual
+	void
+	preparer(int lot)
+	{
+	    (void) lot;
+	    delete partie_;
+	    partie_ = new jeu::Partie(goban_, spectateur_, spectateur_);
+	    for (int c = 0; c < (int) coups_.size() / 2; ++c) {
+		partie_->jouer(coups_[c]);
+	    }
+	}
+
+	virtual
+	long
+	operer(int lot)
+	{
+	    (void) lot;
+	    long nbOperations = 0;
+	    for (int c = coups_.size() / 2; c < (int) coups_.size(); ++c) {
+		puits += partie_->jouer(coups_[c]);
+		++nbOperations;
+	    }
+	    return nbOperations;
+	}
+
+    private:
+
+	const jeu::Goban& goban_;
+
+	jeu::Spectateur spectateur_;
+
+	std::vector<jeu::Coup> coups_;
+
+	jeu::Partie* partie_;
+
+    };
+
+}
+
+int
+main(int argc, char** argv)
+{
+    if (argc > 1) {
+	dureeMesure = std::atof(argv[1]);
+    }
+
+    std::printf("# operation taille ns/op allocations/op operations\n");
+    const int tailles[] = {9, 13, 19};
+    for (int t = 0; t < 3; ++t) {
+	jeu::Goban goban(tailles[t]);
+	Positions positions(goban);
+
+	MesurePoser(positions).executer("poser", tailles[t]);
+	MesureMort(positions).executer("mort", tailles[t]);
+	MesureTuer(positions).executer("tuer", tailles[t]);
+	MesureFinir(positions).executer("finir", tailles[t]);
+	MesureCopie(positions).executer("copie", tailles[t]);
+	MesurePartie(goban).executer("partie_poser", tailles[t]);
+    }
+    return 0;
+}
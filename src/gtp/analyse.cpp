@@ -0,0 +1,378 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/bitboard.hpp>
+#include <jeu/joueur.hpp>
+#include <jeu/partie.hpp>
+#include <jeu/generateur.hpp>
+#include <jeu/sgf.hpp>
+
+#include <ia/arbre.hpp>
+#include <ia/recherche.hpp>
+
+#include <gtp/moteur.hpp>
+#include <gtp/analyse.hpp>
+
+namespace gtp {
+
+    namespace {
+
+	/**
+	 * \brief Enfant de la racine retenu pour la réponse.
+	 */
+	struct Candidat {
+
+	    jeu::Coup coup;
+
+	    int visites;
+
+	    double victoire;
+
+	};
+
+	bool
+	plusVisite(const Candidat& a, const Candidat& b)
+	{
+	    return a.visites > b.visites;
+	}
+
+	/**
+	 * \brief Nombre de requêtes en attente par recherche.
+	 */
+	const int REQUETES_PAR_RECHERCHE = 2;
+
+    }
+
+    Analyse::Analyse(const ia::Parametres& parametres, int nbRecherches)
+	: parametres_(parametres),
+	  nbRecherches_(std::max(nbRecherches, 1)),
+	  requetes_(),
+	  fin_(false),
+	  mutexRequetes_(),
+	  requeteDisponible_(),
+	  placeLibre_(),
+	  gobans_(),
+	  out_(NULL),
+	  mutexReponses_()
+    {
+	parametres_.capaciteArbre =
+	    std::max(parametres_.capaciteArbre / nbRecherches_, 1 << 12);
+	parametres_.tailleTranspositions =
+	    std::max(parametres_.tailleTranspositions / nbRecherches_, 1);
+	parametres_.reflexion = false;
+	parametres_.messages = false;
+	parametres_.possession = true;
+    }
+
+    void
+    Analyse::executer(std::istream& in, std::ostream& out)
+    {
+	out_ = &out;
+	fin_ = false;
+
+	std::vector<std::thread> threads;
+	for (int r = 0; r < nbRecherches_; ++r) {
+	    threads.push_back(std::thread(&Analyse::travailler, this,
+					  (uint64_t) rand()));
+	}
+
+	std::string ligne;
+	while (std::getline(in, ligne)) {
+	    std::string::size_type debut = ligne.find_first_not_of(" \t\r");
+	    if (debut == std::string::npos || ligne[debut] == '#') {
+		continue;
+	    }
+	    std::unique_lock<std::mutex> verrou(mutexRequetes_);
+	    while ((int) requetes_.size()
+		   >= REQUETES_PAR_RECHERCHE * nbRecherches_) {
+		placeLibre_.wait(verrou);
+	    }
+	    requetes_.push_back(ligne.substr(debut));
+	    requeteDisponible_.notify_one();
+	}
+
+	{
+	    std::lock_guard<std::mutex> verrou(mutexRequetes_);
+	    fin_ = true;
+	}
+	requeteDisponible_.notify_all();
+	for (unsigned int t = 0; t < threads.size(); ++t) {
+	    threads[t].join();
+	}
+	out_ = NULL;
+    }
+
+    void
+    Analyse::travailler(uint64_t graine)
+    {
+	jeu::Generateur generateur(graine);
+	ia::Recherche recherche(parametres_, generateur);
+	std::string reponse;
+	while (true) {
+	    std::string ligne;
+	    {
+		std::unique_lock<std::mutex> verrou(mutexRequetes_);
+		while (requetes_.empty() && !fin_) {
+		    requeteDisponible_.wait(verrou);
+		}
+		if (requetes_.empty()) {
+		    return;
+		}
+		ligne.swap(requetes_.front());
+		requetes_.pop_front();
+	    }
+	    placeLibre_.notify_one();
+
+	    analyser(ligne, recherche, reponse);
+
+	    std::lock_guard<std::mutex> verrou(mutexReponses_);
+	    *out_ << reponse << std::endl;
+	}
+    }
+
+    void
+    Analyse::analyser(const std::string& ligne, ia::Recherche& recherche,
+		      std::string& reponse)
+    {
+	std::string identifiant;
+	jeu::PartieSgf requete;
+	int visites = parametres_.nbSimulations;
+	double temps = 0;
+	int nbMeilleurs = 10;
+	std::string erreur;
+	std::ostringstream flux;
+
+	if (!lire(ligne, identifiant, requete, visites, temps,
+		  nbMeilleurs, erreur)) {
+	    flux << "{\"id\":\"" << proteger(identifiant)
+		 << "\",\"erreur\":\"" << erreur << "\"}";
+	    reponse = flux.str();
+	    return;
+	}
+
+	// la position est rejouée dans une partie pour que le
+	// superko soit vérifié, le komi étant arrondi au demi-point
+	int demiKomi = (int) std::floor(2 * requete.komi + 0.5);
+	jeu::EtatGoban etat(gobans_.goban(requete.taille, demiKomi));
+	jeu::Spectateur spectateur;
+	if (!requete.placer(etat)) {
+	    erreur = "illegal setup";
+	}
+	jeu::Partie partie(etat, requete.premierNoir, spectateur, spectateur);
+	if (erreur.empty() && !requete.rejouer(partie)) {
+	    erreur = "illegal move";
+	}
+	if (erreur.empty() && partie.finie()) {
+	    erreur = "game over";
+	}
+	if (!erreur.empty()) {
+	    flux << "{\"id\":\"" << proteger(identifiant)
+		 << "\",\"erreur\":\"" << erreur << "\"}";
+	    reponse = flux.str();
+	    return;
+	}
+
+	// chaque position est recherchée indépendamment des
+	// précédentes
+	recherche.vider();
+	recherche.initialiser(partie.etatCourant(), partie.tourNoir(),
+			      partie.dernierCoup());
+	if (temps > 0) {
+	    recherche.simulerPendant(temps, temps);
+	}
+	else {
+	    recherche.simuler(visites);
+	}
+
+	// les taux de victoire des enfants de la racine sont ceux du
+	// joueur qui a le trait
+	const ia::Arbre& arbre = recherche.arbre();
+	const ia::Noeud& racine = arbre.noeud(arbre.racine());
+	std::vector<Candidat> candidats;
+	for (int e = racine.premierEnfant;
+	     e < racine.premierEnfant + racine.nbEnfants; ++e) {
+	    const ia::Noeud& enfant = arbre.noeud(e);
+	    Candidat candidat;
+	    candidat.coup = enfant.coup;
+	    candidat.visites = enfant.visites.load(std::memory_order_relaxed);
+	    candidat.victoire = enfant.tauxVictoire();
+	    if (candidat.visites > 0) {
+		candidats.push_back(candidat);
+	    }
+	}
+	std::stable_sort(candidats.begin(), candidats.end(), plusVisite);
+	if ((int) candidats.size() > nbMeilleurs) {
+	    candidats.resize(nbMeilleurs);
+	}
+
+	char nombre[16];
+	flux << "{\"id\":\"" << proteger(identifiant)
+	     << "\",\"visites\":"
+	     << racine.visites.load(std::memory_order_relaxed)
+	     << ",\"victoire\":";
+	std::snprintf(nombre, sizeof(nombre), "%.4f",
+		      candidats.empty() ? 0.5 : candidats[0].victoire);
+	flux << nombre << ",\"coups\":[";
+	for (unsigned int c = 0; c < candidats.size(); ++c) {
+	    std::snprintf(nombre, sizeof(nombre), "%.4f",
+			  candidats[c].victoire);
+	    flux << (c > 0 ? "," : "") << "{\"coup\":\""
+		 << Moteur::ecrireCoup(candidats[c].coup)
+		 << "\",\"visites\":" << candidats[c].visites
+		 << ",\"victoire\":" << nombre << "}";
+	}
+	flux << "],\"possession\":[";
+
+	std::vector<double> possession;
+	recherche.possession(possession);
+	int taille = requete.taille;
+	for (int i = taille - 1; i >= 0; --i) {
+	    for (int j = 0; j < taille; ++j) {
+		std::snprintf(nombre, sizeof(nombre), "%.2f",
+			      possession[i + taille * j]);
+		flux << (i < taille - 1 || j > 0 ? "," : "") << nombre;
+	    }
+	}
+	flux << "]}";
+	reponse = flux.str();
+    }
+
+    bool
+    Analyse::lire(const std::string& ligne, std::string& identifiant,
+		  jeu::PartieSgf& partie, int& visites, double& temps,
+		  int& nbMeilleurs, std::string& erreur)
+    {
+	std::istringstream flux(ligne);
+	flux >> identifiant;
+
+	// la taille est lue avant les coordonnées qui en dépendent
+	std::vector<std::pair<std::string, std::string> > options;
+	std::string mot;
+	while (flux >> mot) {
+	    std::string::size_type egal = mot.find('=');
+	    if (egal == std::string::npos) {
+		erreur = "syntax error";
+		return false;
+	    }
+	    options.push_back(std::make_pair(mot.substr(0, egal),
+					     mot.substr(egal + 1)));
+	}
+
+	partie.vider();
+	partie.taille = 19;
+	partie.komi = 0;
+	for (unsigned int o = 0; o < options.size(); ++o) {
+	    if (options[o].first == "taille") {
+		std::istringstream valeur(options[o].second);
+		if (!(valeur >> partie.taille) || partie.taille < 2 ||
+		    partie.taille > jeu::Bitboard::TAILLE_MAX) {
+		    erreur = "unacceptable size";
+		    return false;
+		}
+	    }
+	}
+
+	for (unsigned int o = 0; o < options.size(); ++o) {
+	    const std::string& nom = options[o].first;
+	    std::istringstream valeur(options[o].second);
+	    bool valide = true;
+	    if (nom == "taille") {
+		continue;
+	    }
+	    else if (nom == "komi") {
+		valide = (bool) (valeur >> partie.komi);
+	    }
+	    else if (nom == "visites") {
+		valide = (valeur >> visites) && visites > 0;
+	    }
+	    else if (nom == "temps") {
+		valide = (valeur >> temps) && temps > 0;
+	    }
+	    else if (nom == "meilleurs") {
+		valide = (valeur >> nbMeilleurs) && nbMeilleurs >= 0;
+	    }
+	    else if (nom == "trait") {
+		valide = Moteur::lireCouleur(options[o].second,
+					     partie.premierNoir);
+	    }
+	    else if (nom == "coups") {
+		valide = lireCoups(options[o].second, partie.taille,
+				   partie.coups);
+	    }
+	    else if (nom == "noires" || nom == "blanches") {
+		std::vector<jeu::Coup> pierres;
+		valide = lireCoups(options[o].second, partie.taille, pierres);
+		std::vector<jeu::Intersection>& liste =
+		    nom == "noires" ? partie.noires : partie.blanches;
+		for (unsigned int p = 0; valide && p < pierres.size(); ++p) {
+		    valide = pierres[p].type == jeu::TC_POSER;
+		    liste.push_back(pierres[p].intersection);
+		}
+	    }
+	    else {
+		erreur = "unknown option " + proteger(nom);
+		return false;
+	    }
+	    if (!valide) {
+		erreur = "invalid " + proteger(nom);
+		return false;
+	    }
+	}
+	return true;
+    }
+
+    bool
+    Analyse::lireCoups(const std::string& texte, int taille,
+		       std::vector<jeu::Coup>& coups)
+    {
+	std::istringstream flux(texte);
+	std::string mot;
+	while (std::getline(flux, mot, ',')) {
+	    jeu::Coup coup;
+	    if (!Moteur::lireCoup(mot, taille, coup)) {
+		return false;
+	    }
+	    coups.push_back(coup);
+	}
+	return true;
+    }
+
+    std::string
+    Analyse::proteger(const std::string& texte)
+    {
+	std::string resultat;
+	for (std::string::size_type n = 0; n < texte.size(); ++n) {
+	    unsigned char c = texte[n];
+	    if (c == '"' || c == '\\') {
+		resultat += '\\';
+		resultat += c;
+	    }
+	    else if (c < 0x20) {
+		char code[8];
+		std::snprintf(code, sizeof(code), "\\u%04x", c);
+		resultat += code;
+	    }
+	    else {
+		resultat += c;
+	    }
+	}
+	return resultat;
+    }
+
+}
@@ -0,0 +1,185 @@
+#ifndef GTP_ANALYSE_HPP
+#define GTP_ANALYSE_HPP
+
+#include <stdint.h> // uint64_t
+#include <condition_variable> // std::condition_variable
+#include <deque> // std::deque
+#include <istream> // std::istream
+#include <mutex> // std::mutex
+#include <ostream> // std::ostream
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <jeu/goban.hpp> // jeu::Gobans
+#include <jeu/sgf.hpp> // jeu::PartieSgf
+
+#include <ia/recherche.hpp> // ia::Parametres, ia::Recherche
+
+namespace gtp {
+
+    /**
+     * \brief Analyse d'une suite de positions, lues sur un flux
+     *        d'entrée et recherchées en parallèle.
+     *
+     * Chaque ligne du flux est une requête, formée d'un
+     * identifiant suivi d'options de la forme nom=valeur :
+     *
+     *     id [taille=19] [komi=7.5] [noires=D4,Q16] [blanches=C3]
+     *        [trait=B] [coups=D4,Q16,pass] [visites=N] [temps=s]
+     *        [meilleurs=10]
+     *
+     * Les pierres noires et blanches sont placées sur le goban
+     * vide, puis les coups sont joués en alternance à partir du
+     * joueur qui a le trait ; les coordonnées sont celles du
+     * protocole. La recherche dure le temps demandé, en secondes,
+     * ou à défaut le nombre de visites demandé. Par défaut, le
+     * goban est de 19 sans komi, noir a le trait, la recherche
+     * fait le nombre de simulations des paramètres et les dix
+     * coups les plus visités sont donnés.
+     *
+     * Plusieurs recherches indépendantes tournent en même temps,
+     * chacune dans son thread. La réponse à une requête est écrite
+     * dès que sa recherche est finie, sur une ligne au format JSON
+     * rappelant son identifiant, si bien que les réponses peuvent
+     * arriver dans un autre ordre que les requêtes :
+     *
+     *     {"id":"…","visites":N,"victoire":x,
+     *      "coups":[{"coup":"D4","visites":n,"victoire":x},…],
+     *      "possession":[…]}
+     *
+     * Les taux de victoire sont ceux du joueur qui a le trait. La
+     * possession va de -1 pour blanc à 1 pour noir ; elle est
+     * donnée ligne par ligne depuis la ligne du haut, chaque ligne
+     * de la colonne A à la dernière. Une requête invalide reçoit
+     * la réponse {"id":"…","erreur":"…"}.
+     *
+     * Comme pour le protocole, le komi est arrondi au demi-point.
+     */
+    class Analyse {
+
+    public:
+
+	/**
+	 * \brief Constructeur d'analyse avec un nombre donné de
+	 *        recherches simultanées.
+	 *
+	 * La capacité de l'arbre et la taille de la table de
+	 * transposition des paramètres sont partagées entre les
+	 * recherches.
+	 */
+	Analyse(const ia::Parametres& parametres, int nbRecherches);
+
+	/**
+	 * \brief Lecture des requêtes jusqu'à la fin du flux et
+	 *        écriture des réponses.
+	 *
+	 * La fonction rend la main une fois toutes les requêtes
+	 * traitées.
+	 */
+	void
+	executer(std::istream& in, std::ostream& out);
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	Analyse(const Analyse&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	Analyse&
+	operator=(const Analyse&);
+
+	/**
+	 * \brief Traitement des requêtes par l'un des threads,
+	 *        jusqu'à ce qu'il n'y en ait plus.
+	 */
+	void
+	travailler(uint64_t graine);
+
+	/**
+	 * \brief Recherche d'une requête, dont la réponse est placée
+	 *        dans le second paramètre.
+	 */
+	void
+	analyser(const std::string& ligne, ia::Recherche& recherche,
+		 std::string& reponse);
+
+	/**
+	 * \brief Lecture d'une requête.
+	 *
+	 * La valeur de retour indique si la requête est valide ; si
+	 * ce n'est pas le cas, le dernier paramètre en donne la
+	 * raison.
+	 */
+	static
+	bool
+	lire(const std::string& ligne, std::string& identifiant,
+	     jeu::PartieSgf& partie, int& visites, double& temps,
+	     int& nbMeilleurs, std::string& erreur);
+
+	/**
+	 * \brief Lecture d'une liste de coups séparés par des
+	 *        virgules.
+	 */
+	static
+	bool
+	lireCoups(const std::string& texte, int taille,
+		  std::vector<jeu::Coup>& coups);
+
+	/**
+	 * \brief Texte protégé pour une chaîne JSON.
+	 */
+	static
+	std::string
+	proteger(const std::string& texte);
+
+	/**
+	 * \brief Paramètres de chacune des recherches.
+	 */
+	ia::Parametres parametres_;
+
+	int nbRecherches_;
+
+	/**
+	 * \brief Requêtes lues mais pas encore prises par un thread.
+	 *
+	 * La file est bornée, afin que le flux d'entrée ne soit pas
+	 * lu plus vite que les requêtes ne sont traitées.
+	 */
+	std::deque<std::string> requetes_;
+
+	/**
+	 * \brief Savoir si le flux d'entrée est terminé.
+	 */
+	bool fin_;
+
+	std::mutex mutexRequetes_;
+
+	/**
+	 * \brief Conditions signalant une requête à prendre et une
+	 *        place libre dans la file.
+	 */
+	std::condition_variable requeteDisponible_;
+	std::condition_variable placeLibre_;
+
+	/**
+	 * \brief Gobans des requêtes, partagés entre les threads.
+	 */
+	jeu::Gobans gobans_;
+
+	/**
+	 * \brief Flux des réponses, NULL hors de executer().
+	 */
+	std::ostream* out_;
+
+	std::mutex mutexReponses_;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * \file gtp.cpp
+ * \brief Point d'entrée du moteur en mode texte, piloté par le
+ *        Go Text Protocol sur l'entrée et la sortie standard.
+ *
+ * Les messages de la recherche sont écrits sur la sortie
+ * d'erreur.
+ *
+ * Avec l'option -a, le moteur analyse à la place une suite de
+ * positions avec le nombre de recherches simultanées demandé
+ * (voir gtp::Analyse) ; chaque recherche n'a alors qu'un thread,
+ * sauf si l'option -t est donnée.
+ *
+ * Usage : knittuk-gtp [-s simulations] [-t threads]
+ *                     [-b bibliotheque] [-a recherches]
+ */
+
+#include <cstdio> // std::fprintf
+#include <cstdlib> // std::atoi, srand
+#include <ctime> // time
+
+#include <iostream> // std::cin, std::cout
+#include <string> // std::string
+
+#include <ia/recherche.hpp>
+
+#include <gtp/moteur.hpp>
+#include <gtp/analyse.hpp>
+
+int
+main(int argc, char** argv)
+{
+    srand(time(NULL));
+
+    ia::Parametres parametres;
+    std::string bibliotheque;
+    int nbRecherches = 0;
+    bool threads = false;
+    for (int a = 1; a + 1 < argc; a += 2) {
+	std::string option = argv[a];
+	if (option == "-s") {
+	    parametres.nbSimulations = std::atoi(argv[a + 1]);
+	}
+	else if (option == "-t") {
+	    parametres.nbThreads = std::atoi(argv[a + 1]);
+	    threads = true;
+	}
+	else if (option == "-b") {
+	    bibliotheque = argv[a + 1];
+	}
+	else if (option == "-a") {
+	    nbRecherches = std::atoi(argv[a + 1]);
+	}
+	else {
+	    std::fprintf(stderr, "option inconnue : %s\n", argv[a]);
+	    return 1;
+	}
+    }
+    if (nbRecherches > 0 && !threads) {
+	parametres.nbThreads = 1;
+    }
+    if (parametres.nbThreads < 1) {
+	parametres.nbThreads = 1;
+    }
+
+    if (nbRecherches > 0) {
+	gtp::Analyse analyse(parametres, nbRecherches);
+	analyse.executer(std::cin, std::cout);
+	return 0;
+    }
+
+    gtp::Moteur moteur(parametres);
+    if (!bibliotheque.empty() &&
+	!moteur.joueur().ouvrirBibliotheque(bibliotheque)) {
+	std::fprintf(stderr, "impossible d'ouvrir %s\n",
+		     bibliotheque.c_str());
+    }
+
+    moteur.executer(std::cin, std::cout);
+    return 0;
+}
@@ -0,0 +1,392 @@
+#include <cctype>
+#include <cmath>
+
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/bitboard.hpp>
+#include <jeu/partie.hpp>
+
+#include <ia/recherche.hpp>
+#include <ia/joueur.hpp>
+
+#include <gtp/moteur.hpp>
+
+namespace gtp {
+
+    namespace {
+
+	/**
+	 * \brief Commandes connues, dans l'ordre de list_commands.
+	 */
+	const char* const COMMANDES[] = {
+	    "protocol_version",
+	    "name",
+	    "version",
+	    "known_command",
+	    "list_commands",
+	    "quit",
+	    "boardsize",
+	    "clear_board",
+	    "komi",
+	    "play",
+	    "genmove",
+	    "undo",
+	    "final_score",
+	    "showboard"
+	};
+
+	const int NB_COMMANDES = sizeof(COMMANDES) / sizeof(*COMMANDES);
+
+	bool
+	connue(const std::string& nom)
+	{
+	    for (int c = 0; c < NB_COMMANDES; ++c) {
+		if (nom == COMMANDES[c]) {
+		    return true;
+		}
+	    }
+	    return false;
+	}
+
+	/**
+	 * \brief Mise en forme d'une ligne reçue : suppression des
+	 *        caractères de contrôle et du commentaire, tabulations
+	 *        changées en espaces.
+	 */
+	std::string
+	nettoyer(const std::string& ligne)
+	{
+	    std::string resultat;
+	    for (std::string::size_type n = 0; n < ligne.size(); ++n) {
+		char c = ligne[n];
+		if (c == '#') {
+		    break;
+		}
+		if (c == '\t') {
+		    resultat += ' ';
+		}
+		else if (!std::iscntrl((unsigned char) c)) {
+		    resultat += c;
+		}
+	    }
+	    return resultat;
+	}
+
+	std::string
+	minuscules(std::string mot)
+	{
+	    for (std::string::size_type n = 0; n < mot.size(); ++n) {
+		mot[n] = std::tolower((unsigned char) mot[n]);
+	    }
+	    return mot;
+	}
+
+    }
+
+    const char Moteur::COLONNES[] = "ABCDEFGHJKLMNOPQRSTUVWXYZ";
+
+    Moteur::Moteur(const ia::Parametres& parametres)
+	: taille_(19),
+	  demiKomi_(0),
+	  joueur_(parametres),
+	  gobans_(),
+	  partie_(NULL),
+	  termine_(false)
+    {
+	nouvellePartie(taille_, demiKomi_, std::vector<jeu::Coup>());
+    }
+
+    Moteur::~Moteur()
+    {
+	delete partie_;
+    }
+
+    void
+    Moteur::executer(std::istream& in, std::ostream& out)
+    {
+	std::string ligne;
+	while (!termine_ && std::getline(in, ligne)) {
+	    ligne = nettoyer(ligne);
+	    std::istringstream flux(ligne);
+
+	    // identifiant numérique facultatif
+	    std::string identifiant;
+	    std::string mot;
+	    if (!(flux >> mot)) {
+		continue;
+	    }
+	    if (std::isdigit((unsigned char) mot[0])) {
+		identifiant = mot;
+		std::getline(flux, ligne);
+	    }
+	    else {
+		ligne = ligne.substr(ligne.find(mot));
+	    }
+
+	    std::string reponse;
+	    bool reussite = commande(ligne, reponse);
+	    out << (reussite ? '=' : '?') << identifiant;
+	    if (!reponse.empty()) {
+		out << ' ' << reponse;
+	    }
+	    out << "\n\n" << std::flush;
+	}
+    }
+
+    bool
+    Moteur::commande(const std::string& ligne, std::string& reponse)
+    {
+	std::istringstream flux(ligne);
+	std::string nom;
+	flux >> nom;
+	std::vector<std::string> arguments;
+	std::string argument;
+	while (flux >> argument) {
+	    arguments.push_back(argument);
+	}
+	reponse.clear();
+
+	if (nom == "protocol_version") {
+	    reponse = "2";
+	}
+	else if (nom == "name") {
+	    reponse = "knittuk";
+	}
+	else if (nom == "version") {
+	    reponse = "";
+	}
+	else if (nom == "known_command") {
+	    reponse = !arguments.empty() && connue(arguments[0])
+		? "true" : "false";
+	}
+	else if (nom == "list_commands") {
+	    for (int c = 0; c < NB_COMMANDES; ++c) {
+		reponse += (c > 0 ? "\n" : "");
+		reponse += COMMANDES[c];
+	    }
+	}
+	else if (nom == "quit") {
+	    termine_ = true;
+	}
+	else if (nom == "boardsize") {
+	    int taille;
+	    if (arguments.size() != 1 ||
+		!(std::istringstream(arguments[0]) >> taille)) {
+		reponse = "boardsize not an integer";
+		return false;
+	    }
+	    if (taille < 2 || taille > jeu::Bitboard::TAILLE_MAX) {
+		reponse = "unacceptable size";
+		return false;
+	    }
+	    nouvellePartie(taille, demiKomi_, std::vector<jeu::Coup>());
+	}
+	else if (nom == "clear_board") {
+	    nouvellePartie(taille_, demiKomi_, std::vector<jeu::Coup>());
+	}
+	else if (nom == "komi") {
+	    double komi;
+	    if (arguments.size() != 1 ||
+		!(std::istringstream(arguments[0]) >> komi)) {
+		reponse = "komi not a float";
+		return false;
+	    }
+	    // le komi est arrondi au demi-point
+	    int demiKomi = (int) std::floor(2 * komi + 0.5);
+	    if (demiKomi != demiKomi_) {
+		std::vector<jeu::Coup> coups(partie_->historique());
+		nouvellePartie(taille_, demiKomi, coups);
+	    }
+	}
+	else if (nom == "play") {
+	    bool noir;
+	    jeu::Coup coup;
+	    if (arguments.size() != 2 || !lireCouleur(arguments[0], noir) ||
+		!lireCoup(arguments[1], taille_, coup)) {
+		reponse = "invalid color or coordinate";
+		return false;
+	    }
+	    // le protocole ne finit pas la partie après deux passes
+	    partie_->reprendre();
+	    bool passe = donnerTrait(noir);
+	    if (!partie_->jouer(coup)) {
+		// le passe inséré ne doit pas survivre au coup refusé
+		if (passe) {
+		    partie_->annuler();
+		}
+		reponse = "illegal move";
+		return false;
+	    }
+	}
+	else if (nom == "genmove") {
+	    bool noir;
+	    if (arguments.size() != 1 || !lireCouleur(arguments[0], noir)) {
+		reponse = "invalid color";
+		return false;
+	    }
+	    partie_->reprendre();
+	    donnerTrait(noir);
+	    // seule une perte au temps empêche de reprendre la partie
+	    if (partie_->finie()) {
+		reponse = "pass";
+		return true;
+	    }
+	    partie_->tourSuivant();
+	    reponse = ecrireCoup(partie_->historique().back());
+
+	    // le joueur réfléchit pendant le tour de l'adversaire
+	    if (!partie_->finie()) {
+		partie_->annoncerTour();
+	    }
+	}
+	else if (nom == "undo") {
+	    if (!partie_->annuler()) {
+		reponse = "cannot undo";
+		return false;
+	    }
+	}
+	else if (nom == "final_score") {
+	    jeu::Score score = partie_->etatCourant().scoreSurface();
+	    double ecart = (score.noir - score.blanc) / 2.0;
+	    std::ostringstream resultat;
+	    if (ecart > 0) {
+		resultat << "B+" << ecart;
+	    }
+	    else if (ecart < 0) {
+		resultat << "W+" << -ecart;
+	    }
+	    else {
+		resultat << "0";
+	    }
+	    reponse = resultat.str();
+	}
+	else if (nom == "showboard") {
+	    reponse = ecrireGoban(partie_->etatCourant());
+	}
+	else {
+	    reponse = "unknown command";
+	    return false;
+	}
+	return true;
+    }
+
+    void
+    Moteur::nouvellePartie(int taille, int demiKomi,
+			   const std::vector<jeu::Coup>& coups)
+    {
+	delete partie_;
+	taille_ = taille;
+	demiKomi_ = demiKomi;
+	partie_ = new jeu::Partie(gobans_.goban(taille, demiKomi),
+				  joueur_, joueur_);
+	partie_->debut();
+	for (std::vector<jeu::Coup>::const_iterator it = coups.begin();
+	     it != coups.end(); ++it) {
+	    partie_->jouer(*it);
+	}
+    }
+
+    bool
+    Moteur::donnerTrait(bool noir)
+    {
+	if (partie_->tourNoir() == noir) {
+	    return false;
+	}
+	jeu::Coup passe;
+	passe.type = jeu::TC_PASSER;
+	return partie_->jouer(passe);
+    }
+
+    bool
+    Moteur::lireCouleur(const std::string& mot, bool& noir)
+    {
+	std::string couleur = minuscules(mot);
+	if (couleur == "b" || couleur == "black") {
+	    noir = true;
+	    return true;
+	}
+	if (couleur == "w" || couleur == "white") {
+	    noir = false;
+	    return true;
+	}
+	return false;
+    }
+
+    bool
+    Moteur::lireCoup(const std::string& mot, int taille, jeu::Coup& coup)
+    {
+	if (minuscules(mot) == "pass") {
+	    coup = jeu::Coup();
+	    coup.type = jeu::TC_PASSER;
+	    return true;
+	}
+	if (mot.size() < 2) {
+	    return false;
+	}
+	char lettre = std::toupper((unsigned char) mot[0]);
+	int colonne = -1;
+	for (int c = 0; c < taille; ++c) {
+	    if (COLONNES[c] == lettre) {
+		colonne = c;
+	    }
+	}
+	int ligne;
+	std::istringstream flux(mot.substr(1));
+	char reste;
+	if (colonne < 0 || !(flux >> ligne) || (flux >> reste) ||
+	    ligne < 1 || ligne > taille) {
+	    return false;
+	}
+	coup = jeu::Coup(jeu::Intersection(ligne - 1, colonne));
+	return true;
+    }
+
+    std::string
+    Moteur::ecrireCoup(const jeu::Coup& coup)
+    {
+	if (coup.type != jeu::TC_POSER) {
+	    return "pass";
+	}
+	std::ostringstream flux;
+	flux << COLONNES[coup.intersection.j] << coup.intersection.i + 1;
+	return flux.str();
+    }
+
+    std::string
+    Moteur::ecrireGoban(const jeu::EtatGoban& etat)
+    {
+	int taille = etat.goban().taille();
+	std::ostringstream lettres;
+	lettres << "   ";
+	for (int j = 0; j < taille; ++j) {
+	    lettres << ' ' << COLONNES[j];
+	}
+
+	// la réponse commence à la ligne suivante et ne doit pas
+	// contenir de ligne vide, qui la terminerait
+	std::ostringstream flux;
+	flux << "\n" << lettres.str();
+	for (int i = taille - 1; i >= 0; --i) {
+	    flux << "\n" << std::setw(3) << i + 1;
+	    for (int j = 0; j < taille; ++j) {
+		jeu::Intersection inter(i, j);
+		char c = etat[inter] == jeu::EI_NOIR ? 'X'
+		    : etat[inter] == jeu::EI_BLANC ? 'O'
+		    : etat.goban().hoshi(inter) ? '+' : '.';
+		flux << ' ' << c;
+	    }
+	    flux << ' ' << i + 1;
+	}
+	flux << "\n" << lettres.str();
+	return flux.str();
+    }
+
+}
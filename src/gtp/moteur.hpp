@@ -0,0 +1,185 @@
+#ifndef GTP_MOTEUR_HPP
+#define GTP_MOTEUR_HPP
+
+#include <istream> // std::istream
+#include <ostream> // std::ostream
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <jeu/types.hpp> // jeu::Coup
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/goban.hpp> // jeu::Goban
+#include <jeu/partie.hpp> // jeu::Partie
+
+#include <ia/recherche.hpp> // ia::Parametres
+#include <ia/joueur.hpp> // ia::JoueurIntelligent
+
+namespace gtp {
+
+    /**
+     * \brief Moteur de jeu piloté par le Go Text Protocol.
+     *
+     * Les commandes sont lues une par ligne et appliquées à une
+     * partie dont les deux joueurs sont le même joueur
+     * intelligent : les coups de l'adversaire sont imposés à la
+     * partie par la commande play, et genmove fait jouer le joueur
+     * intelligent pour la couleur demandée.
+     *
+     * Le protocole permet de jouer deux fois de suite avec la même
+     * couleur ; un passe de l'autre couleur est alors inséré. Il
+     * ne finit pas non plus la partie après deux passes : un coup
+     * reçu ensuite la reprend, par exemple pour retirer des
+     * pierres mortes contestées.
+     *
+     * Le komi du protocole est arrondi au demi-point, unité dans
+     * laquelle le goban le compte.
+     */
+    class Moteur {
+
+    public:
+
+	/**
+	 * \brief Constructeur de moteur avec une partie sur un goban
+	 *        de 19 sans komi.
+	 */
+	explicit
+	Moteur(const ia::Parametres& parametres);
+
+	~Moteur();
+
+	/**
+	 * \brief Lecture et exécution des commandes jusqu'à la
+	 *        commande quit ou la fin du flux.
+	 */
+	void
+	executer(std::istream& in, std::ostream& out);
+
+	/**
+	 * \brief Exécution d'une commande, sans son identifiant.
+	 *
+	 * La valeur de retour indique si la commande a réussi ; la
+	 * réponse, ou le message d'erreur, est placée dans le
+	 * second paramètre.
+	 */
+	bool
+	commande(const std::string& ligne, std::string& reponse);
+
+	/**
+	 * \brief Accès au joueur intelligent.
+	 */
+	inline
+	ia::JoueurIntelligent&
+	joueur()
+	{
+	    return joueur_;
+	}
+
+	/**
+	 * \brief Savoir si la commande quit a été reçue.
+	 */
+	inline
+	bool
+	termine() const
+	{
+	    return termine_;
+	}
+
+	/**
+	 * \brief Lecture d'une couleur du protocole.
+	 */
+	static
+	bool
+	lireCouleur(const std::string& mot, bool& noir);
+
+	/**
+	 * \brief Lecture d'un coup du protocole.
+	 *
+	 * Les colonnes sont notées par des lettres, I exclu, et les
+	 * lignes par des numéros à partir de 1.
+	 */
+	static
+	bool
+	lireCoup(const std::string& mot, int taille, jeu::Coup& coup);
+
+	/**
+	 * \brief Écriture d'un coup du protocole.
+	 */
+	static
+	std::string
+	ecrireCoup(const jeu::Coup& coup);
+
+	/**
+	 * \brief Écriture d'un goban pour la commande showboard.
+	 *
+	 * Les pierres noires sont notées X, les blanches O, les
+	 * intersections vides . et les hoshi vides + ; les colonnes
+	 * et les lignes sont repérées comme dans les coups, la ligne
+	 * 1 en bas.
+	 */
+	static
+	std::string
+	ecrireGoban(const jeu::EtatGoban& etat);
+
+	/**
+	 * \brief Lettres des colonnes, I exclu.
+	 */
+	static const char COLONNES[];
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	Moteur(const Moteur&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	Moteur&
+	operator=(const Moteur&);
+
+	/**
+	 * \brief Remplacement de la partie par une nouvelle, sur un
+	 *        goban de taille et de komi donnés, où les coups
+	 *        passés en paramètre sont rejoués.
+	 *
+	 * Le komi est en demi-points. Les coups qui ne sont pas licites sur le nouveau goban sont
+	 * ignorés.
+	 */
+	void
+	nouvellePartie(int taille, int demiKomi,
+		       const std::vector<jeu::Coup>& coups);
+
+	/**
+	 * \brief Insertion d'un passe si la couleur passée en
+	 *        paramètre n'a pas le trait.
+	 *
+	 * La valeur de retour indique si un passe a été inséré.
+	 */
+	bool
+	donnerTrait(bool noir);
+
+	int taille_;
+
+	/**
+	 * \brief Komi demandé, en demi-points.
+	 */
+	int demiKomi_;
+
+	ia::JoueurIntelligent joueur_;
+
+	/**
+	 * \brief Gobans des parties successives, gardés car le
+	 *        joueur intelligent garde des états qui les désignent.
+	 */
+	jeu::Gobans gobans_;
+
+	jeu::Partie* partie_;
+
+	bool termine_;
+
+    };
+
+}
+
+#endif
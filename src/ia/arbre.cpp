@@ -0,0 +1,113 @@
+#include <vector>
+#include <atomic>
+
+#include <jeu/types.hpp>
+
+#include <ia/arbre.hpp>
+
+namespace ia {
+
+    Arbre::Arbre(int capacite)
+	: noeuds_(capacite),
+	  nouveauxIndices_(),
+	  nbNoeuds_(1)
+    {
+    }
+
+    void
+    Arbre::vider()
+    {
+	// les autres nœuds seront réinitialisés par developper()
+	noeuds_[0].reinitialiser(jeu::Coup());
+	nbNoeuds_.store(1, std::memory_order_relaxed);
+    }
+
+    void
+    Arbre::conserver(int n)
+    {
+	int nb = nbNoeuds();
+	nouveauxIndices_.assign(nb, -1);
+
+	// marquage du sous-arbre : les enfants d'un nœud ont des
+	// indices plus grands que lui, donc un parcours croissant
+	// à partir de n rencontre chaque parent avant ses enfants
+	nouveauxIndices_[n] = 0;
+	for (int i = n; i < nb; ++i) {
+	    if (nouveauxIndices_[i] >= 0 && noeuds_[i].developpe()) {
+		const Noeud& noeud = noeuds_[i];
+		for (int e = noeud.premierEnfant;
+		     e < noeud.premierEnfant + noeud.nbEnfants; ++e) {
+		    nouveauxIndices_[e] = 0;
+		}
+	    }
+	}
+
+	// déplacement des nœuds marqués vers le début du tableau ;
+	// un nœud n'est jamais déplacé vers un indice plus grand, donc
+	// jamais sur un nœud qui reste à déplacer
+	int compteur = 0;
+	for (int i = n; i < nb; ++i) {
+	    if (nouveauxIndices_[i] >= 0) {
+		nouveauxIndices_[i] = compteur++;
+	    }
+	}
+	for (int i = n; i < nb; ++i) {
+	    int j = nouveauxIndices_[i];
+	    if (j < 0) {
+		continue;
+	    }
+	    Noeud& noeud = noeuds_[j];
+	    if (j != i) {
+		noeud.copier(noeuds_[i]);
+	    }
+	    if (noeud.developpe()) {
+		noeud.premierEnfant = nouveauxIndices_[noeud.premierEnfant];
+	    }
+	    else {
+		// un nœud resté en développement faute de place pourra
+		// être développé à nouveau
+		noeud.premierEnfant = -1;
+		noeud.nbEnfants = 0;
+		noeud.developpement.store(Noeud::NON_DEVELOPPE,
+					  std::memory_order_relaxed);
+	    }
+	}
+	noeuds_[0].coup = jeu::Coup();
+
+	// les nœuds libérés seront réinitialisés par developper()
+	nbNoeuds_.store(compteur, std::memory_order_relaxed);
+    }
+
+    bool
+    Arbre::developper(int n, const std::vector<jeu::Coup>& coups)
+    {
+	Noeud& parent = noeuds_[n];
+	int attendu = Noeud::NON_DEVELOPPE;
+	if (!parent.developpement.compare_exchange_strong(
+		attendu, Noeud::EN_DEVELOPPEMENT)) {
+	    return false;
+	}
+
+	// la réservation ne fait jamais dépasser la capacité au
+	// compteur, qui ne peut donc pas déborder ; un arbre plein
+	// laisse le nœud en cours de développement, ce qui évite aux
+	// autres threads de réessayer
+	int nb = coups.size();
+	int premier = nbNoeuds_.load(std::memory_order_relaxed);
+	do {
+	    if (nb > capacite() - premier) {
+		return false;
+	    }
+	} while (!nbNoeuds_.compare_exchange_weak(
+		     premier, premier + nb, std::memory_order_relaxed));
+
+	for (int i = 0; i < nb; ++i) {
+	    noeuds_[premier + i].reinitialiser(coups[i]);
+	}
+	parent.premierEnfant = premier;
+	parent.nbEnfants = nb;
+	parent.developpement.store(Noeud::DEVELOPPE, std::memory_order_release);
+	return true;
+    }
+
+}
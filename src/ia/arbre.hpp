@@ -0,0 +1,321 @@
+#ifndef IA_ARBRE_HPP
+#define IA_ARBRE_HPP
+
+#include <vector> // std::vector
+#include <atomic> // std::atomic
+
+#include <jeu/types.hpp> // jeu::Coup
+
+namespace ia {
+
+    /**
+     * \brief Structure représentant un nœud de l'arbre de recherche.
+     *
+     * Un nœud correspond au coup qui y mène depuis son parent. Ses
+     * statistiques sont vues du joueur qui a joué ce coup : les
+     * victoires sont celles de ce joueur. Les enfants d'un nœud
+     * sont rangés de façon contiguë dans l'arbre.
+     *
+     * Les statistiques sont atomiques afin que plusieurs threads
+     * puissent parcourir et mettre à jour l'arbre sans verrou. Les
+     * champs premierEnfant et nbEnfants ne doivent être lus
+     * qu'après avoir constaté que le nœud est développé.
+     */
+    struct Noeud {
+
+	/**
+	 * \brief États de développement d'un nœud.
+	 */
+	enum Developpement {
+	    NON_DEVELOPPE,
+	    EN_DEVELOPPEMENT,
+	    DEVELOPPE
+	};
+
+	/**
+	 * \brief Coup menant à ce nœud.
+	 */
+	jeu::Coup coup;
+
+	/**
+	 * \brief Indice du premier enfant, ou -1 si le nœud n'a pas
+	 *        été développé.
+	 */
+	int premierEnfant;
+
+	/**
+	 * \brief Nombre d'enfants.
+	 */
+	int nbEnfants;
+
+	/**
+	 * \brief Nombre de simulations passées par ce nœud, y
+	 *        compris celles qui sont en cours.
+	 */
+	std::atomic<int> visites;
+
+	/**
+	 * \brief Nombre de simulations gagnées par le joueur ayant
+	 *        joué le coup, compté en demi-victoires afin qu'une
+	 *        égalité compte pour moitié.
+	 */
+	std::atomic<int> demiVictoires;
+
+	/**
+	 * \brief Nombre de simulations dans lesquelles le joueur
+	 *        ayant joué le coup l'a joué, depuis le parent du
+	 *        nœud, avant son adversaire (statistiques AMAF, « all
+	 *        moves as first »).
+	 */
+	std::atomic<int> visitesAmaf;
+
+	/**
+	 * \brief Demi-victoires correspondant à visitesAmaf.
+	 */
+	std::atomic<int> demiVictoiresAmaf;
+
+	/**
+	 * \brief Statistiques de la position du nœud dans la table
+	 *        de transposition, lues lors du dernier passage.
+	 *
+	 * Elles comprennent les simulations du nœud et celles des
+	 * autres chemins menant à la même position. Elles ne servent
+	 * qu'à la sélection ; visites et demiVictoires restent celles
+	 * du nœud.
+	 */
+	std::atomic<int> visitesTransposition;
+	std::atomic<int> demiVictoiresTransposition;
+
+	/**
+	 * \brief État de développement du nœud.
+	 */
+	std::atomic<int> developpement;
+
+	/**
+	 * \brief Constructeur de nœud non visité.
+	 */
+	Noeud(const jeu::Coup& c = jeu::Coup())
+	{
+	    reinitialiser(c);
+	}
+
+	/**
+	 * \brief Remise du nœud à l'état non visité.
+	 *
+	 * Ne doit pas être appelée pendant une recherche.
+	 */
+	inline
+	void
+	reinitialiser(const jeu::Coup& c)
+	{
+	    coup = c;
+	    premierEnfant = -1;
+	    nbEnfants = 0;
+	    visites.store(0, std::memory_order_relaxed);
+	    demiVictoires.store(0, std::memory_order_relaxed);
+	    visitesAmaf.store(0, std::memory_order_relaxed);
+	    demiVictoiresAmaf.store(0, std::memory_order_relaxed);
+	    visitesTransposition.store(0, std::memory_order_relaxed);
+	    demiVictoiresTransposition.store(0, std::memory_order_relaxed);
+	    developpement.store(NON_DEVELOPPE, std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Copie du contenu d'un autre nœud.
+	 *
+	 * Ne doit pas être appelée pendant une recherche.
+	 */
+	inline
+	void
+	copier(const Noeud& noeud)
+	{
+	    coup = noeud.coup;
+	    premierEnfant = noeud.premierEnfant;
+	    nbEnfants = noeud.nbEnfants;
+	    visites.store(noeud.visites.load(std::memory_order_relaxed),
+			  std::memory_order_relaxed);
+	    demiVictoires.store(
+		noeud.demiVictoires.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	    visitesAmaf.store(
+		noeud.visitesAmaf.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	    demiVictoiresAmaf.store(
+		noeud.demiVictoiresAmaf.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	    visitesTransposition.store(
+		noeud.visitesTransposition.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	    demiVictoiresTransposition.store(
+		noeud.demiVictoiresTransposition.load(
+		    std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	    developpement.store(
+		noeud.developpement.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Savoir si les enfants du nœud peuvent être lus.
+	 */
+	inline
+	bool
+	developpe() const
+	{
+	    return developpement.load(std::memory_order_acquire) == DEVELOPPE;
+	}
+
+	/**
+	 * \brief Taux de victoire du joueur ayant joué le coup, ou
+	 *        0.5 si le nœud n'a pas été visité.
+	 */
+	inline
+	double
+	tauxVictoire() const
+	{
+	    int n = visites.load(std::memory_order_relaxed);
+	    if (n == 0) {
+		return 0.5;
+	    }
+	    return demiVictoires.load(std::memory_order_relaxed) / (2.0 * n);
+	}
+
+    private:
+
+	Noeud(const Noeud&);
+
+	Noeud& operator=(const Noeud&);
+
+    };
+
+    /**
+     * \brief Classe représentant un arbre de recherche.
+     *
+     * Les nœuds sont stockés dans un tableau de capacité fixe,
+     * alloué une fois pour toutes, et désignés par leur indice, la
+     * racine ayant l'indice 0. Les nouveaux nœuds sont réservés par
+     * une boucle de compare-and-swap sur leur nombre, qui échoue
+     * sans rien réserver si la capacité serait dépassée, si bien
+     * que plusieurs threads peuvent développer des nœuds différents
+     * en même temps ; un nœud donné n'est développé que par un seul
+     * thread.
+     */
+    class Arbre {
+
+    public:
+
+	/**
+	 * \brief Constructeur d'arbre réduit à sa racine.
+	 */
+	explicit
+	Arbre(int capacite);
+
+	/**
+	 * \brief Réduction de l'arbre à une racine non visitée.
+	 *
+	 * Ne doit pas être appelée pendant une recherche.
+	 */
+	void
+	vider();
+
+	/**
+	 * \brief Réduction de l'arbre au sous-arbre d'un nœud, qui
+	 *        devient la racine.
+	 *
+	 * Les nœuds conservés sont déplacés au début du tableau en
+	 * une passe, dans l'ordre de leurs indices, ce qui préserve la
+	 * contiguïté des enfants ; tous les autres sont libérés
+	 * d'un coup. Ne doit pas être appelée pendant une recherche.
+	 */
+	void
+	conserver(int n);
+
+	/**
+	 * \brief Indice de la racine.
+	 */
+	inline
+	int
+	racine() const
+	{
+	    return 0;
+	}
+
+	/**
+	 * \brief Accès à un nœud.
+	 */
+	inline
+	Noeud&
+	noeud(int n)
+	{
+	    return noeuds_[n];
+	}
+
+	/**
+	 * \brief Accès à un nœud depuis un objet const.
+	 */
+	inline
+	const Noeud&
+	noeud(int n) const
+	{
+	    return noeuds_[n];
+	}
+
+	/**
+	 * \brief Nombre de nœuds de l'arbre.
+	 */
+	inline
+	int
+	nbNoeuds() const
+	{
+	    return nbNoeuds_.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Nombre maximal de nœuds.
+	 */
+	inline
+	int
+	capacite() const
+	{
+	    return noeuds_.size();
+	}
+
+	/**
+	 * \brief Développement d'un nœud.
+	 *
+	 * Un enfant est créé pour chacun des coups passés en
+	 * paramètre. La valeur de retour est faux si un autre thread
+	 * développe déjà le nœud ou si l'arbre est plein ; le nœud
+	 * reste alors une feuille pour le thread appelant.
+	 */
+	bool
+	developper(int n, const std::vector<jeu::Coup>& coups);
+
+    private:
+
+	Arbre(const Arbre&);
+
+	Arbre& operator=(const Arbre&);
+
+	std::vector<Noeud> noeuds_;
+
+	/**
+	 * \brief Nouveaux indices des nœuds lors de conserver(), -1
+	 *        pour les nœuds libérés.
+	 */
+	std::vector<int> nouveauxIndices_;
+
+	/**
+	 * \brief Nombre de nœuds réservés, jamais supérieur à la
+	 *        capacité.
+	 *
+	 * Il n'est augmenté que par compare-and-swap, après
+	 * vérification que la réservation tient dans la capacité.
+	 */
+	std::atomic<int> nbNoeuds_;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,187 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <jeu/types.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/generateur.hpp>
+#include <jeu/symetrie.hpp>
+
+#include <ia/bibliotheque.hpp>
+
+namespace ia {
+
+    namespace {
+
+	/**
+	 * \brief Ordre des entrées par clé.
+	 */
+	bool
+	avant(const Bibliotheque::Entree& e1, const Bibliotheque::Entree& e2)
+	{
+	    return e1.cle < e2.cle;
+	}
+
+    }
+
+    const char Bibliotheque::MAGIE[8] = {'K', 'N', 'T', 'K', 'B', 'I', 'B', '2'};
+
+    Bibliotheque::Bibliotheque()
+	: projection_(NULL),
+	  longueur_(0),
+	  enTete_(NULL),
+	  entrees_(NULL)
+    {
+    }
+
+    Bibliotheque::~Bibliotheque()
+    {
+	fermer();
+    }
+
+    bool
+    Bibliotheque::ouvrir(const std::string& fichier)
+    {
+	fermer();
+
+	int fd = open(fichier.c_str(), O_RDONLY);
+	if (fd < 0) {
+	    return false;
+	}
+	struct stat infos;
+	if (fstat(fd, &infos) != 0 ||
+	    (std::size_t) infos.st_size < sizeof(EnTete)) {
+	    close(fd);
+	    return false;
+	}
+	longueur_ = infos.st_size;
+	void* projection = mmap(NULL, longueur_, PROT_READ, MAP_PRIVATE, fd, 0);
+	// la projection reste valide après la fermeture du fichier
+	close(fd);
+	if (projection == MAP_FAILED) {
+	    longueur_ = 0;
+	    return false;
+	}
+	projection_ = projection;
+
+	const EnTete* enTete = static_cast<const EnTete*>(projection_);
+	if (std::memcmp(enTete->magie, MAGIE, sizeof(MAGIE)) != 0 ||
+	    longueur_ != sizeof(EnTete) + enTete->nbEntrees * sizeof(Entree)) {
+	    fermer();
+	    return false;
+	}
+	enTete_ = enTete;
+	entrees_ = reinterpret_cast<const Entree*>(enTete_ + 1);
+	return true;
+    }
+
+    void
+    Bibliotheque::fermer()
+    {
+	if (projection_ != NULL) {
+	    munmap(projection_, longueur_);
+	}
+	projection_ = NULL;
+	longueur_ = 0;
+	enTete_ = NULL;
+	entrees_ = NULL;
+    }
+
+    jeu::Coup
+    Bibliotheque::choisir(const jeu::EtatGoban& etat, bool tourNoir,
+			  jeu::Generateur& generateur,
+			  const std::vector<jeu::Coup>& exclus) const
+    {
+	int taille = etat.goban().taille();
+	if (!ouverte() || taille != this->taille()) {
+	    return jeu::Coup();
+	}
+
+	jeu::Symetrie symetrie;
+	Entree recherchee;
+	recherchee.cle = cle(etat, tourNoir, symetrie);
+	jeu::Symetrie retour = symetrie.inverse();
+	std::pair<const Entree*, const Entree*> intervalle =
+	    std::equal_range(entrees_, entrees_ + enTete_->nbEntrees,
+			     recherchee, avant);
+
+	// tirage selon les poids parmi les coups encore possibles
+	jeu::Coup choisi;
+	uint64_t total = 0;
+	for (const Entree* e = intervalle.first; e != intervalle.second; ++e) {
+	    jeu::Coup coup = retour.appliquer(decoder(e->coup, taille), taille);
+	    if (coup.type == jeu::TC_INVALIDE || e->poids == 0 ||
+		(coup.type == jeu::TC_POSER &&
+		 !etat.licite(coup.intersection, tourNoir)) ||
+		std::find(exclus.begin(), exclus.end(), coup) != exclus.end()) {
+		continue;
+	    }
+	    total += e->poids;
+	    if (generateur() % total < e->poids) {
+		choisi = coup;
+	    }
+	}
+	return choisi;
+    }
+
+    uint64_t
+    Bibliotheque::cle(const jeu::EtatGoban& etat, bool tourNoir,
+		      jeu::Symetrie& symetrie)
+    {
+	return etat.hashCanonique(tourNoir, symetrie);
+    }
+
+    uint16_t
+    Bibliotheque::coder(const jeu::Coup& coup, int taille)
+    {
+	if (coup.type != jeu::TC_POSER) {
+	    return PASSE;
+	}
+	return coup.intersection.i + taille * coup.intersection.j;
+    }
+
+    jeu::Coup
+    Bibliotheque::decoder(uint16_t coup, int taille)
+    {
+	jeu::Coup resultat;
+	if (coup == PASSE) {
+	    resultat.type = jeu::TC_PASSER;
+	}
+	else if (coup < taille * taille) {
+	    resultat = jeu::Coup(jeu::Intersection(coup % taille, coup / taille));
+	}
+	return resultat;
+    }
+
+    bool
+    Bibliotheque::ecrire(const std::string& fichier, int taille,
+			 std::vector<Entree>& entrees)
+    {
+	std::stable_sort(entrees.begin(), entrees.end(), avant);
+
+	EnTete enTete;
+	std::memcpy(enTete.magie, MAGIE, sizeof(MAGIE));
+	enTete.taille = taille;
+	enTete.nbEntrees = entrees.size();
+
+	std::FILE* f = std::fopen(fichier.c_str(), "wb");
+	if (f == NULL) {
+	    return false;
+	}
+	bool ok = std::fwrite(&enTete, sizeof(enTete), 1, f) == 1 &&
+	    (entrees.empty() ||
+	     std::fwrite(&entrees[0], sizeof(Entree), entrees.size(), f)
+	     == entrees.size());
+	return std::fclose(f) == 0 && ok;
+    }
+
+}
@@ -0,0 +1,229 @@
+#ifndef IA_BIBLIOTHEQUE_HPP
+#define IA_BIBLIOTHEQUE_HPP
+
+#include <cstddef> // std::size_t
+#include <stdint.h> // uint64_t, uint32_t, uint16_t
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <jeu/types.hpp> // jeu::Coup
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/generateur.hpp> // jeu::Generateur
+#include <jeu/symetrie.hpp> // jeu::Symetrie
+
+namespace ia {
+
+    /**
+     * \brief Bibliothèque d'ouvertures projetée en mémoire.
+     *
+     * Le fichier commence par un en-tête suivi d'un tableau
+     * d'entrées (clé de position, coup, poids) trié par clé. Il est
+     * projeté en mémoire avec mmap à l'ouverture, sans lecture ni
+     * analyse : une recherche est une dichotomie dans le tableau
+     * projeté, et seules les pages consultées sont chargées.
+     *
+     * Les positions sont ramenées à leur forme canonique, et les
+     * coups exprimés dans celle-ci : une entrée sert pour les 8
+     * positions symétriques.
+     *
+     * Les entiers sont stockés dans l'ordre des octets de la
+     * machine qui a construit le fichier.
+     */
+    class Bibliotheque {
+
+    public:
+
+	/**
+	 * \brief En-tête du fichier.
+	 */
+	struct EnTete {
+
+	    /**
+	     * \brief Signature du format, égale à MAGIE.
+	     */
+	    char magie[8];
+
+	    /**
+	     * \brief Taille du goban des positions.
+	     */
+	    uint32_t taille;
+
+	    uint32_t nbEntrees;
+
+	};
+
+	/**
+	 * \brief Coup de la bibliothèque pour une position.
+	 */
+	struct Entree {
+
+	    /**
+	     * \brief Clé de la forme canonique de la position, trait
+	     *        compris.
+	     *
+	     * @see cle()
+	     */
+	    uint64_t cle;
+
+	    /**
+	     * \brief Identifiant de l'intersection jouée dans la forme
+	     *        canonique, au sens de jeu::Goban::id(), ou PASSE.
+	     */
+	    uint16_t coup;
+
+	    uint16_t reserve;
+
+	    /**
+	     * \brief Poids du coup, proportionnel à sa probabilité
+	     *        d'être choisi.
+	     */
+	    uint32_t poids;
+
+	};
+
+	/**
+	 * \brief Signature des fichiers de bibliothèque.
+	 */
+	static const char MAGIE[8];
+
+	/**
+	 * \brief Valeur du champ coup pour un coup qui passe.
+	 */
+	static const uint16_t PASSE = 0xffff;
+
+	/**
+	 * \brief Constructeur de bibliothèque vide.
+	 */
+	Bibliotheque();
+
+	/**
+	 * \brief Destructeur, qui libère la projection.
+	 */
+	~Bibliotheque();
+
+	/**
+	 * \brief Projection d'un fichier en mémoire.
+	 *
+	 * La valeur de retour indique si le fichier a pu être ouvert
+	 * et si son en-tête est valide. En cas d'échec la
+	 * bibliothèque est vide.
+	 */
+	bool
+	ouvrir(const std::string& fichier);
+
+	/**
+	 * \brief Libération de la projection.
+	 */
+	void
+	fermer();
+
+	/**
+	 * \brief Savoir si un fichier est projeté.
+	 */
+	inline
+	bool
+	ouverte() const
+	{
+	    return enTete_ != NULL;
+	}
+
+	/**
+	 * \brief Taille du goban des positions, nulle si la
+	 *        bibliothèque est vide.
+	 */
+	inline
+	int
+	taille() const
+	{
+	    return enTete_ ? enTete_->taille : 0;
+	}
+
+	inline
+	int
+	nbEntrees() const
+	{
+	    return enTete_ ? enTete_->nbEntrees : 0;
+	}
+
+	/**
+	 * \brief Tirage d'un coup de la bibliothèque pour une
+	 *        position.
+	 *
+	 * Le coup est tiré selon les poids parmi les coups licites de
+	 * la position qui ne sont pas exclus. S'il n'y en a aucun, le
+	 * coup retourné est invalide.
+	 */
+	jeu::Coup
+	choisir(const jeu::EtatGoban& etat, bool tourNoir,
+		jeu::Generateur& generateur,
+		const std::vector<jeu::Coup>& exclus) const;
+
+	/**
+	 * \brief Clé d'une position dans la bibliothèque.
+	 *
+	 * La symétrie passée en paramètre reçoit celle qui envoie la
+	 * position sur sa forme canonique, à appliquer aux coups avant
+	 * de les coder.
+	 *
+	 * @see jeu::EtatGoban::hashCanonique()
+	 */
+	static
+	uint64_t
+	cle(const jeu::EtatGoban& etat, bool tourNoir,
+	    jeu::Symetrie& symetrie);
+
+	/**
+	 * \brief Codage d'un coup dans une entrée.
+	 */
+	static
+	uint16_t
+	coder(const jeu::Coup& coup, int taille);
+
+	/**
+	 * \brief Décodage d'un coup d'une entrée.
+	 */
+	static
+	jeu::Coup
+	decoder(uint16_t coup, int taille);
+
+	/**
+	 * \brief Écriture d'un fichier de bibliothèque.
+	 *
+	 * Les entrées sont triées avant l'écriture. La valeur de
+	 * retour indique si l'écriture a réussi.
+	 */
+	static
+	bool
+	ecrire(const std::string& fichier, int taille,
+	       std::vector<Entree>& entrees);
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	Bibliotheque(const Bibliotheque&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	Bibliotheque&
+	operator=(const Bibliotheque&);
+
+	/**
+	 * \brief Adresse de la projection, NULL si aucun fichier
+	 *        n'est projeté.
+	 */
+	void* projection_;
+
+	std::size_t longueur_;
+
+	const EnTete* enTete_;
+
+	const Entree* entrees_;
+
+    };
+
+}
+
+#endif
@@ -1,17 +1,48 @@
 #include <cstdlib>
-#include <climits>
 
 #include <vector>
+#include <string>
+#include <algorithm> // std::min, std::max
+
+#include <iostream>
 
 #include <jeu/types.hpp>
-#include <jeu/partie.hpp>
 #include <jeu/joueur.hpp>
 
+#include <ia/recherche.hpp>
+#include <ia/bibliotheque.hpp>
 #include <ia/joueur.hpp>
 
 namespace ia {
 
     JoueurIntelligent::JoueurIntelligent()
+	: couleurConnue_(false),
+	  estNoir_(false),
+	  generateur_(rand()),
+	  recherche_(Parametres(), generateur_),
+	  bibliotheque_(),
+	  recherchee_(false)
+    {
+    }
+
+    JoueurIntelligent::JoueurIntelligent(const Parametres& parametres)
+	: couleurConnue_(false),
+	  estNoir_(false),
+	  generateur_(rand()),
+	  recherche_(parametres, generateur_),
+	  bibliotheque_(),
+	  recherchee_(false)
+    {
+    }
+
+    JoueurIntelligent::JoueurIntelligent(const Parametres& parametres,
+					 uint64_t graine)
+	: couleurConnue_(false),
+	  estNoir_(false),
+	  generateur_(graine),
+	  recherche_(parametres, generateur_),
+	  bibliotheque_(),
+	  recherchee_(false)
     {
     }
 
@@ -22,55 +53,100 @@ namespace ia {
 	noir_ = noir;
 	etat_ = etat;
 	dernierCoup_ = dernierCoup;
-	nbEssais_ = 0;
+	proposes_.clear();
+	recherchee_ = false;
+
+	// l'arbre est suivi à chaque tour, y compris ceux de
+	// l'adversaire, pour descendre successivement vers notre coup
+	// puis vers sa réponse ; la réflexion en cours est arrêtée
+	recherche_.avancer(etat, noir, dernierCoup);
+
+	// pendant le tour de l'adversaire, la recherche continue en
+	// arrière-plan depuis la position courante
+	if (recherche_.parametres().reflexion &&
+	    couleurConnue_ && noir != estNoir_) {
+	    recherche_.demarrer(recherche_.parametres().nbSimulationsReflexion);
+	}
     }
 
     jeu::Coup
     JoueurIntelligent::jouer()
     {
-	int n = 100;
-	int deltaMoy = 0;
-	int deltaMax = INT_MIN;
-	int indiceDeltaMax = -1;
-	std::vector<jeu::Intersection> intersections(n);
-	//std::map<jeu::Intersection, int> moy;
-	for (int i = 0; i < n; ++i) {
-            jeu::Intersection& inter = intersections[i];
-            //Joueur noir;
-	    //Joueur blanc;
-	    jeu::JoueurAleatoire noir;
-	    jeu::JoueurAleatoire blanc;
-	    jeu::EtatGoban etat(etat_);
-	    do {
-		inter.i = rand() % etat.goban().taille();
-		inter.j = rand() % etat.goban().taille();
-	    } while (!etat.poser(inter, noir_));
-
-	    jeu::Partie partie(etat, !noir_, noir, blanc);
-	    partie.debut();
-	    while (!partie.finie()) {
-		partie.tourSuivant();
+	couleurConnue_ = true;
+	estNoir_ = noir_;
+
+	// tant que la position est connue, le coup vient de la
+	// bibliothèque
+	if (!recherchee_) {
+	    jeu::Coup coup =
+		bibliotheque_.choisir(etat_, noir_, generateur_, proposes_);
+	    if (coup.type != jeu::TC_INVALIDE) {
+		proposes_.push_back(coup);
+		if (recherche_.parametres().messages) {
+		    std::cerr << "bibliotheque" << std::endl;
+		}
+		return coup;
 	    }
-	    while (!partie.fin()) {
+	}
+
+	// la recherche n'est faite qu'une fois par tour ; si la
+	// partie refuse le coup, le suivant le plus visité est proposé
+	if (!recherchee_) {
+	    recherchee_ = true;
+	    if (pendule_.illimitee()) {
+		recherche_.simuler(recherche_.parametres().nbSimulations);
 	    }
-	    const jeu::Score& score = partie.etatCourant().score();
-	    int delta = noir_ ? (score.noir - score.blanc) : (score.blanc - score.noir);
-	    deltaMoy += delta;
-	    if (delta > deltaMax) {
-		deltaMax = delta;
-		indiceDeltaMax = i;
+	    else {
+		double budget;
+		double limite;
+		allouerTemps(budget, limite);
+		int nbSimulations = recherche_.simulerPendant(budget, limite);
+		if (recherche_.parametres().messages) {
+		    std::cerr << "simulations " << nbSimulations << std::endl;
+		}
 	    }
 	}
-	deltaMoy /= n;
 
-	std::cout << "moy " << deltaMoy << std::endl;
-	std::cout << "max " << deltaMax << std::endl;
+	jeu::Coup coup = recherche_.meilleurCoup(proposes_);
+	proposes_.push_back(coup);
+
+	if (recherche_.parametres().messages) {
+	    std::cerr << "noeuds " << recherche_.arbre().nbNoeuds() << std::endl;
+	    std::cerr << "victoires " << recherche_.tauxVictoire(coup)
+		      << std::endl;
+	}
 
-	jeu::Coup coup;
-	coup.type = jeu::TC_POSER;
-	coup.intersection = intersections[indiceDeltaMax];
 	return coup;
     }
 
-}
+    void
+    JoueurIntelligent::tempsRestant(const jeu::Pendule& pendule)
+    {
+	pendule_ = pendule;
+    }
+
+    bool
+    JoueurIntelligent::ouvrirBibliotheque(const std::string& fichier)
+    {
+	return bibliotheque_.ouvrir(fichier);
+    }
 
+    void
+    JoueurIntelligent::allouerTemps(double& budget, double& limite) const
+    {
+	double principal = pendule_.tempsPrincipal();
+	double periode = pendule_.nbPeriodes() > 0
+	    ? pendule_.dureePeriode() : 0;
+
+	// le temps déjà écoulé depuis le déclenchement de la pendule
+	// est déduit
+	double sur = principal / 2 + periode
+	    - recherche_.parametres().margeTemps - pendule_.tempsEcoule();
+
+	int coupsRestants = std::max(etat_.nbVides() / 2, 10);
+	budget = std::max(principal / coupsRestants, 0.7 * periode);
+	limite = std::max(std::min(3 * budget, sur), 0.0);
+	budget = std::min(budget, limite);
+    }
+
+}
@@ -1,12 +1,29 @@
 #ifndef IA_JOUEUR_HPP
 #define IA_JOUEUR_HPP
 
+#include <vector>
+#include <string>
+#include <stdint.h>
+
 #include <jeu/joueur.hpp>
+#include <jeu/generateur.hpp>
+
+#include <ia/recherche.hpp>
+#include <ia/bibliotheque.hpp>
 
 namespace ia {
     
     /**
      * \brief Joueur ordinateur.
+     *
+     * Le coup est choisi par une recherche arborescente
+     * Monte-Carlo depuis l'état du début du tour. L'arbre est
+     * conservé d'un tour à l'autre et, pendant le tour de
+     * l'adversaire, la recherche continue en arrière-plan depuis
+     * la position courante.
+     *
+     * Si une bibliothèque d'ouvertures a été ouverte et qu'elle
+     * connaît la position, le coup en est tiré sans recherche.
      */
     class JoueurIntelligent : public jeu::Joueur {
 
@@ -17,6 +34,19 @@ namespace ia {
 	 */
 	JoueurIntelligent();
 
+	/**
+	 * \brief Constructeur de joueur intelligent avec des
+	 *        paramètres de recherche choisis.
+	 */
+	explicit
+	JoueurIntelligent(const Parametres& parametres);
+
+	/**
+	 * \brief Constructeur de joueur intelligent avec des
+	 *        paramètres de recherche et une graine choisis.
+	 */
+	JoueurIntelligent(const Parametres& parametres, uint64_t graine);
+
 	virtual
 	void
 	debutTour(bool noir, const jeu::EtatGoban& etat,
@@ -26,15 +56,69 @@ namespace ia {
 	jeu::Coup
 	jouer();
 
+	virtual
+	void
+	tempsRestant(const jeu::Pendule& pendule);
+
+	/**
+	 * \brief Ouverture d'une bibliothèque d'ouvertures.
+	 *
+	 * La valeur de retour indique si le fichier a pu être
+	 * projeté en mémoire.
+	 */
+	bool
+	ouvrirBibliotheque(const std::string& fichier);
+
     private:
 
+	/**
+	 * \brief Calcul du temps de réflexion pour le coup en cours.
+	 *
+	 * Le budget est une part du temps principal restant, estimée
+	 * d'après le nombre d'intersections vides, ou la majeure
+	 * partie d'une période de byo-yomi si c'est plus. La limite,
+	 * atteinte seulement dans les positions indécises, ne dépasse
+	 * jamais la moitié du temps principal plus une période, marge
+	 * de sécurité déduite.
+	 */
+	void
+	allouerTemps(double& budget, double& limite) const;
+
 	bool noir_;
 
 	jeu::EtatGoban etat_;
 
 	jeu::Coup dernierCoup_;
-	
-	int nbEssais_;
+
+	/**
+	 * \brief Pendule du joueur pour le coup en cours.
+	 */
+	jeu::Pendule pendule_;
+
+	/**
+	 * \brief Savoir si la couleur du joueur est connue, ce qui
+	 *        n'est le cas qu'après son premier coup.
+	 */
+	bool couleurConnue_;
+
+	bool estNoir_;
+
+	jeu::Generateur generateur_;
+
+	Recherche recherche_;
+
+	Bibliotheque bibliotheque_;
+
+	/**
+	 * \brief Savoir si la recherche a déjà été faite pendant le
+	 *        tour.
+	 */
+	bool recherchee_;
+
+	/**
+	 * \brief Coups déjà proposés pendant le tour et refusés.
+	 */
+	std::vector<jeu::Coup> proposes_;
 
     };
 
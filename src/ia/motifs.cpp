@@ -0,0 +1,180 @@
+#include <stdint.h>
+
+#include <jeu/types.hpp>
+#include <jeu/etatgoban.hpp>
+
+#include <ia/motifs.hpp>
+
+namespace ia {
+
+    namespace {
+
+	/**
+	 * \brief Rang de chaque voisin parmi les voisins orthogonaux,
+	 *        dont le motif donne l'atari, ou -1 en diagonale.
+	 */
+	const int RANGS_ATARI[jeu::EtatGoban::NB_VOISINS_MOTIF] =
+	    {-1, 0, -1, 1, 2, -1, 3, -1};
+
+    }
+
+    const Motifs&
+    Motifs::table()
+    {
+	static const Motifs motifs;
+	return motifs;
+    }
+
+    Motifs::Motifs()
+    {
+	for (int m = 0; m < NB_MOTIFS; ++m) {
+	    poids_[m] = 0;
+	}
+
+	// hane
+	ajouter("XOX"
+		"..."
+		"???", 10);
+	ajouter("XO."
+		"..."
+		"?.?", 10);
+	ajouter("XO?"
+		"X.."
+		"x.?", 10);
+	ajouter("XOO"
+		"..."
+		"?.?", 6);
+	ajouter(".O."
+		"X.."
+		"...", 6);
+
+	// coupes
+	ajouter("XO?"
+		"O.o"
+		"?o?", 10);
+	ajouter("XO?"
+		"O.X"
+		"???", 10);
+	ajouter("?X?"
+		"O.O"
+		"ooo", 8);
+	ajouter("OX?"
+		"o.O"
+		"???", 8);
+
+	// bord
+	ajouter("X.?"
+		"O.?"
+		"##?", 6);
+	ajouter("OX?"
+		"X.O"
+		"###", 8);
+	ajouter("?X?"
+		"x.O"
+		"###", 6);
+	ajouter("?XO"
+		"x.x"
+		"###", 6);
+	ajouter("?OX"
+		"X.O"
+		"###", 8);
+	ajouter("?OY"
+		"Y.O"
+		"###", 6);
+    }
+
+    void
+    Motifs::ajouter(const char* forme, int poids)
+    {
+	// transformations du carré : rotations et symétrie
+	for (int t = 0; t < 8; ++t) {
+	    for (int couleurs = 0; couleurs < 2; ++couleurs) {
+		// ensembles d'états, un bit par état et par atari
+		jeu::EtatIntersection x =
+		    couleurs ? jeu::EI_BLANC : jeu::EI_NOIR;
+		jeu::EtatIntersection o =
+		    couleurs ? jeu::EI_NOIR : jeu::EI_BLANC;
+		int noir = 1 << x;
+		int blanc = 1 << o;
+		int noirAtari = 1 << (jeu::NB_EI + x);
+		int blancAtari = 1 << (jeu::NB_EI + o);
+		int vide = 1 << jeu::EI_VIDE;
+		int bord = 1 << jeu::EI_GRIS;
+
+		int permis[jeu::EtatGoban::NB_VOISINS_MOTIF];
+		int v = 0;
+		for (int i = 0; i < 3; ++i) {
+		    for (int j = 0; j < 3; ++j) {
+			if (i == 1 && j == 1) {
+			    continue;
+			}
+
+			// case de la forme qui arrive en (i, j)
+			int a = i - 1;
+			int b = j - 1;
+			if (t & 1) {
+			    int c = a;
+			    a = b;
+			    b = c;
+			}
+			if (t & 2) {
+			    a = -a;
+			}
+			if (t & 4) {
+			    b = -b;
+			}
+			char c = forme[3 * (a + 1) + (b + 1)];
+
+			switch (c) {
+			case 'X': permis[v] = noir | noirAtari; break;
+			case 'O': permis[v] = blanc | blancAtari; break;
+			case 'Y': permis[v] = noir; break;
+			case 'Q': permis[v] = blanc; break;
+			case 'x':
+			    permis[v] = blanc | blancAtari | vide | bord;
+			    break;
+			case 'o':
+			    permis[v] = noir | noirAtari | vide | bord;
+			    break;
+			case '.': permis[v] = vide; break;
+			case '#': permis[v] = bord; break;
+			default:
+			    permis[v] = noir | noirAtari | blanc | blancAtari
+				| vide | bord;
+			    break;
+			}
+			++v;
+		    }
+		}
+		enumerer(permis, 0, 0, poids);
+	    }
+	}
+    }
+
+    void
+    Motifs::enumerer(const int permis[], int v, uint32_t motif, int poids)
+    {
+	if (v == jeu::EtatGoban::NB_VOISINS_MOTIF) {
+	    if (poids_[motif] < poids) {
+		poids_[motif] = poids;
+	    }
+	    return;
+	}
+	int rang = RANGS_ATARI[v];
+	for (int etat = 0; etat < jeu::NB_EI; ++etat) {
+	    uint32_t m = motif | (etat << (2 * v));
+	    bool libre = permis[v] & (1 << etat);
+	    bool atari = permis[v] & (1 << (jeu::NB_EI + etat));
+
+	    // en diagonale, l'atari n'est pas connu
+	    if (libre || (atari && rang < 0)) {
+		enumerer(permis, v + 1, m, poids);
+	    }
+	    if (atari && rang >= 0) {
+		int bit = 2 * jeu::EtatGoban::NB_VOISINS_MOTIF + rang;
+		enumerer(permis, v + 1, m | (1 << bit), poids);
+	    }
+	}
+    }
+
+}
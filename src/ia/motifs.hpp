@@ -0,0 +1,90 @@
+#ifndef IA_MOTIFS_HPP
+#define IA_MOTIFS_HPP
+
+#include <stdint.h> // uint32_t
+
+namespace ia {
+
+    /**
+     * \brief Table des poids des motifs 3x3.
+     *
+     * La table associe à chacun des motifs de huit voisins, ataris
+     * des voisins orthogonaux compris (voir
+     * jeu::EtatGoban::motif()), un poids, nul si le motif ne
+     * correspond à aucune forme intéressante. Les formes sont
+     * celles de MoGo (hane, coupes, formes de bord) ; chacune est
+     * reconnue dans ses huit orientations et pour les deux
+     * couleurs, si bien que le poids ne dépend pas du joueur qui a
+     * le trait. La table est calculée une fois pour toutes.
+     */
+    class Motifs {
+
+    public:
+
+	/**
+	 * \brief Nombre de motifs distincts.
+	 */
+	static const int NB_MOTIFS = 1 << 20;
+
+	/**
+	 * \brief Accès à la table commune, calculée au premier appel.
+	 */
+	static
+	const Motifs&
+	table();
+
+	/**
+	 * \brief Poids d'un motif.
+	 */
+	inline
+	int
+	poids(uint32_t motif) const
+	{
+	    return poids_[motif];
+	}
+
+    private:
+
+	/**
+	 * \brief Constructeur calculant la table.
+	 */
+	Motifs();
+
+	Motifs(const Motifs&);
+
+	Motifs& operator=(const Motifs&);
+
+	/**
+	 * \brief Ajout d'une forme décrite par une chaîne de neuf
+	 *        caractères, ligne par ligne, dans toutes ses
+	 *        orientations et pour les deux couleurs.
+	 *
+	 * Les caractères sont : X et O pour une pierre de chaque
+	 * couleur, Y et Q pour une telle pierre dont la chaîne n'est
+	 * pas en atari, x et o pour tout sauf une pierre X ou O, .
+	 * pour une intersection vide, # pour le bord et ? pour
+	 * n'importe quoi. L'atari n'étant connu que pour les voisins
+	 * orthogonaux, Y et Q valent X et O en diagonale. Le centre
+	 * est l'intersection jouée.
+	 */
+	void
+	ajouter(const char* forme, int poids);
+
+	/**
+	 * \brief Ajout de tous les motifs compatibles avec les
+	 *        ensembles d'états permis pour chaque voisin, à partir
+	 *        du voisin v.
+	 *
+	 * Le bit e d'un ensemble permet l'EtatIntersection e sans
+	 * atari, le bit NB_EI + e une pierre de cet état en atari.
+	 */
+	void
+	enumerer(const int permis[], int v, uint32_t motif, int poids);
+
+	unsigned char poids_[NB_MOTIFS];
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include <vector>
+
+#include <jeu/types.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/generateur.hpp>
+
+#include <ia/motifs.hpp>
+#include <ia/playout.hpp>
+
+namespace ia {
+
+    Playout::Playout(jeu::Generateur& generateur)
+	: generateur_(generateur),
+	  heuristiques_(true),
+	  etat_(),
+	  score_(),
+	  nbCoups_(0),
+	  coups_(),
+	  candidats_(),
+	  poidsCumules_()
+    {
+    }
+
+    int
+    Playout::jouer(const jeu::EtatGoban& depart, bool tourNoir,
+		   const jeu::Coup& dernierCoup)
+    {
+	// la recopie réutilise les tableaux de la simulation
+	// précédente
+	etat_ = depart;
+	coups_.clear();
+
+	int taille = etat_.goban().taille();
+	int nbCoupsMax = 3 * taille * taille;
+	int nbPasses = 0;
+	jeu::Coup dernier = dernierCoup;
+
+	for (nbCoups_ = 0; nbCoups_ < nbCoupsMax && nbPasses < 2; ++nbCoups_) {
+	    jeu::Coup coup = choisir(tourNoir, dernier);
+	    coups_.push_back(coup);
+	    dernier = coup;
+	    if (coup.type == jeu::TC_POSER) {
+		etat_.poser(coup.intersection, tourNoir);
+		nbPasses = 0;
+	    }
+	    else {
+		etat_.passer();
+		++nbPasses;
+	    }
+	    tourNoir = !tourNoir;
+	}
+
+	score_ = etat_.scoreSurface();
+	return score_.noir - score_.blanc;
+    }
+
+    jeu::Coup
+    Playout::choisir(bool tourNoir, const jeu::Coup& dernierCoup)
+    {
+	if (!heuristiques_ || dernierCoup.type != jeu::TC_POSER) {
+	    return etat_.coupAleatoire(tourNoir, generateur_, true);
+	}
+
+	candidats_.clear();
+	poidsCumules_.clear();
+	const jeu::Intersection& dernier = dernierCoup.intersection;
+
+	jeu::EtatIntersection joueur = tourNoir ? jeu::EI_NOIR : jeu::EI_BLANC;
+	jeu::EtatIntersection adversaire =
+	    tourNoir ? jeu::EI_BLANC : jeu::EI_NOIR;
+
+	// capture de la chaîne qui vient d'être jouée
+	if (etat_[dernier] == adversaire && etat_.atari(dernier)) {
+	    proposer(etat_.liberte(dernier), tourNoir, POIDS_CAPTURE);
+	}
+
+	// fuite des chaînes voisines mises en atari
+	jeu::Intersection voisins[jeu::NB_D];
+	dernier.voisins(voisins);
+	for (int d = 0; d < jeu::NB_D; ++d) {
+	    if (etat_[voisins[d]] == joueur && etat_.atari(voisins[d])) {
+		jeu::Intersection liberte = etat_.liberte(voisins[d]);
+		if (!etat_.autoAtari(liberte, tourNoir)) {
+		    proposer(liberte, tourNoir, POIDS_FUITE);
+		}
+	    }
+	}
+
+	// voisins formant un motif connu
+	const Motifs& motifs = Motifs::table();
+	jeu::Intersection inter;
+	for (inter.i = dernier.i - 1; inter.i <= dernier.i + 1; ++inter.i) {
+	    for (inter.j = dernier.j - 1; inter.j <= dernier.j + 1; ++inter.j) {
+		if (etat_[inter] != jeu::EI_VIDE) {
+		    continue;
+		}
+		int poids = motifs.poids(etat_.motif(inter));
+		if (poids > 0 && !etat_.autoAtari(inter, tourNoir)) {
+		    proposer(inter, tourNoir, poids);
+		}
+	    }
+	}
+
+	if (candidats_.empty()) {
+	    return etat_.coupAleatoire(tourNoir, generateur_, true);
+	}
+
+	// tirage selon les poids
+	int tirage = generateur_.entier(poidsCumules_.back());
+	int c = 0;
+	while (poidsCumules_[c] <= tirage) {
+	    ++c;
+	}
+	return jeu::Coup(candidats_[c]);
+    }
+
+    void
+    Playout::proposer(const jeu::Intersection& inter, bool tourNoir, int poids)
+    {
+	if (!etat_.licite(inter, tourNoir) || etat_.oeil(inter, tourNoir)) {
+	    return;
+	}
+	int cumul = poidsCumules_.empty() ? 0 : poidsCumules_.back();
+	candidats_.push_back(inter);
+	poidsCumules_.push_back(cumul + poids);
+    }
+
+}
@@ -0,0 +1,162 @@
+#ifndef IA_PLAYOUT_HPP
+#define IA_PLAYOUT_HPP
+
+#include <vector> // std::vector
+
+#include <jeu/types.hpp> // jeu::Score, jeu::Coup
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/generateur.hpp> // jeu::Generateur
+
+namespace ia {
+
+    /**
+     * \brief Moteur de parties aléatoires rapides.
+     *
+     * Une simulation joue directement sur une copie de l'état du
+     * goban, sans passer par jeu::Partie ni par des jeu::Joueur.
+     * Seul le ko simple est vérifié, et la partie s'arrête après
+     * deux passes consécutives ou un nombre maximal de coups. Les
+     * points sont alors comptés par surface.
+     *
+     * Chaque coup est choisi autour du coup précédent lorsque
+     * c'est possible : capture de la chaîne qui vient d'être
+     * jouée si elle est en atari, fuite d'une chaîne qu'elle
+     * vient de mettre en atari, ou voisin formant un motif 3x3
+     * connu. Ces candidats sont tirés au hasard selon leur poids,
+     * en écartant ceux qui mettraient leur propre chaîne en atari.
+     * À défaut, le coup est tiré uniformément parmi les coups
+     * licites qui ne bouchent pas un œil.
+     *
+     * La copie de travail et la liste des coups joués sont
+     * conservées d'une simulation à l'autre, si bien qu'aucune
+     * allocation n'a lieu pendant une simulation une fois la
+     * première effectuée.
+     */
+    class Playout {
+
+    public:
+
+	/**
+	 * \brief Constructeur de moteur utilisant le générateur
+	 *        passé en paramètre.
+	 */
+	explicit
+	Playout(jeu::Generateur& generateur);
+
+	/**
+	 * \brief Poids d'une capture de la chaîne qui vient d'être
+	 *        jouée.
+	 */
+	static const int POIDS_CAPTURE = 40;
+
+	/**
+	 * \brief Poids d'une fuite d'une chaîne mise en atari.
+	 */
+	static const int POIDS_FUITE = 30;
+
+	/**
+	 * \brief Simulation d'une partie à partir d'un état.
+	 *
+	 * Le dernier coup joué avant l'état de départ oriente le
+	 * premier coup de la simulation. La valeur de retour est la
+	 * différence de demi-points entre noir et blanc à la fin de
+	 * la simulation, komi compris.
+	 */
+	int
+	jouer(const jeu::EtatGoban& depart, bool tourNoir,
+	      const jeu::Coup& dernierCoup = jeu::Coup());
+
+	/**
+	 * \brief Activation des heuristiques locales.
+	 *
+	 * Sans elles, tous les coups sont tirés uniformément.
+	 */
+	inline
+	void
+	heuristiques(bool actives)
+	{
+	    heuristiques_ = actives;
+	}
+
+	/**
+	 * \brief Accès à l'état du goban à la fin de la dernière
+	 *        simulation.
+	 */
+	inline
+	const jeu::EtatGoban&
+	etat() const
+	{
+	    return etat_;
+	}
+
+	/**
+	 * \brief Accès au score de la dernière simulation.
+	 */
+	inline
+	const jeu::Score&
+	score() const
+	{
+	    return score_;
+	}
+
+	/**
+	 * \brief Nombre de coups joués lors de la dernière
+	 *        simulation, passes comprises.
+	 */
+	inline
+	int
+	nbCoups() const
+	{
+	    return nbCoups_;
+	}
+
+	/**
+	 * \brief Coups joués lors de la dernière simulation, passes
+	 *        comprises, les joueurs alternant à partir de celui
+	 *        qui avait le trait au départ.
+	 */
+	inline
+	const std::vector<jeu::Coup>&
+	coups() const
+	{
+	    return coups_;
+	}
+
+    private:
+
+	/**
+	 * \brief Choix d'un coup pour le joueur ayant le trait.
+	 */
+	jeu::Coup
+	choisir(bool tourNoir, const jeu::Coup& dernierCoup);
+
+	/**
+	 * \brief Ajout d'un candidat, s'il est jouable.
+	 */
+	void
+	proposer(const jeu::Intersection& inter, bool tourNoir, int poids);
+
+	jeu::Generateur& generateur_;
+
+	bool heuristiques_;
+
+	jeu::EtatGoban etat_;
+
+	jeu::Score score_;
+
+	int nbCoups_;
+
+	std::vector<jeu::Coup> coups_;
+
+	/**
+	 * \brief Candidats du coup en cours et leurs poids cumulés.
+	 */
+	std::vector<jeu::Intersection> candidats_;
+
+	std::vector<int> poidsCumules_;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,695 @@
+#include <cmath> // std::sqrt, std::log
+#include <cstddef> // std::size_t
+#include <vector>
+#include <atomic>
+#include <thread> // std::thread
+#include <functional> // std::ref
+#include <chrono> // std::chrono::steady_clock
+#include <climits> // INT_MAX
+#include <algorithm> // std::find
+
+#include <jeu/types.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/generateur.hpp>
+
+#include <ia/arbre.hpp>
+#include <ia/playout.hpp>
+#include <ia/transpositions.hpp>
+
+#include <ia/recherche.hpp>
+
+namespace ia {
+
+    Parametres::Parametres()
+	: nbSimulations(10000),
+	  exploration(0.8),
+	  rave(true),
+	  equivalenceRave(1000),
+	  explorationRave(0.3),
+	  heuristiques(false),
+	  seuilDeveloppement(2),
+	  nbThreads(std::thread::hardware_concurrency()),
+	  reflexion(true),
+	  nbSimulationsReflexion(200000),
+	  margeTemps(0.1),
+	  capaciteArbre(1 << 21),
+	  tailleTranspositions(32),
+	  messages(true),
+	  possession(false)
+    {
+	if (nbThreads < 1) {
+	    nbThreads = 1;
+	}
+    }
+
+    Recherche::Travailleur::Travailleur(uint64_t graine, bool heuristiques)
+	: generateur(graine),
+	  playout(generateur),
+	  etat(),
+	  chemin(),
+	  cles(),
+	  sequence(),
+	  premiers(),
+	  coups(),
+	  possession(),
+	  nbPossessions(0)
+    {
+	playout.heuristiques(heuristiques);
+    }
+
+    Recherche::Recherche(const Parametres& parametres,
+			 jeu::Generateur& generateur)
+	: parametres_(parametres),
+	  arbre_(parametres.capaciteArbre),
+	  transpositions_((std::size_t) parametres.tailleTranspositions << 20),
+	  racine_(),
+	  tailleGoban_(0),
+	  tourNoir_(true),
+	  passeRacine_(false),
+	  dernierCoupRacine_(),
+	  travailleurs_(),
+	  threads_(),
+	  restantes_(0)
+    {
+	for (int t = 0; t < parametres_.nbThreads; ++t) {
+	    travailleurs_.push_back(new Travailleur(generateur(),
+						   parametres_.heuristiques));
+	}
+    }
+
+    Recherche::~Recherche()
+    {
+	arreter();
+
+	std::vector<Travailleur*>::iterator it;
+	for (it = travailleurs_.begin(); it != travailleurs_.end(); ++it) {
+	    delete *it;
+	}
+    }
+
+    void
+    Recherche::initialiser(const jeu::EtatGoban& etat, bool tourNoir,
+			   const jeu::Coup& dernierCoup)
+    {
+	arreter();
+	arbre_.vider();
+	preparer(etat, tourNoir, dernierCoup);
+    }
+
+    void
+    Recherche::vider()
+    {
+	arreter();
+	arbre_.vider();
+	transpositions_.vider();
+    }
+
+    bool
+    Recherche::avancer(const jeu::EtatGoban& etat, bool tourNoir,
+		       const jeu::Coup& dernierCoup)
+    {
+	arreter();
+
+	// une position annoncée une seconde fois, par exemple aux
+	// deux joueurs d'une partie contre soi-même, reste la racine
+	if (etat.goban().taille() == tailleGoban_ && tourNoir == tourNoir_ &&
+	    dernierCoup == dernierCoupRacine_ &&
+	    etat.hash(tourNoir) == racine_.hash(tourNoir)) {
+	    return true;
+	}
+
+	int e = -1;
+	if (etat.goban().taille() == tailleGoban_ && tourNoir != tourNoir_) {
+	    e = enfant(dernierCoup);
+	}
+
+	// le hash vérifie que la position atteinte par le coup est
+	// bien celle de la partie
+	if (e >= 0) {
+	    jeu::EtatGoban suivant(racine_);
+	    if (dernierCoup.type == jeu::TC_POSER) {
+		suivant.poser(dernierCoup.intersection, tourNoir_);
+	    }
+	    else {
+		suivant.passer();
+	    }
+	    if (suivant.hash(tourNoir) != etat.hash(tourNoir)) {
+		e = -1;
+	    }
+	}
+
+	if (e < 0) {
+	    initialiser(etat, tourNoir, dernierCoup);
+	    return false;
+	}
+
+	arbre_.conserver(e);
+	preparer(etat, tourNoir, dernierCoup);
+	return true;
+    }
+
+    void
+    Recherche::preparer(const jeu::EtatGoban& etat, bool tourNoir,
+			const jeu::Coup& dernierCoup)
+    {
+	// les positions d'un autre goban ne doivent pas être
+	// confondues avec celles du nouveau
+	if (etat.goban().taille() != tailleGoban_) {
+	    transpositions_.vider();
+	    tailleGoban_ = etat.goban().taille();
+	}
+	transpositions_.nouvelleRecherche();
+
+	racine_ = etat;
+	tourNoir_ = tourNoir;
+	passeRacine_ = dernierCoup.type == jeu::TC_PASSER;
+	dernierCoupRacine_ = dernierCoup;
+
+	if (parametres_.possession) {
+	    for (int t = 0; t < parametres_.nbThreads; ++t) {
+		travailleurs_[t]->possession.assign(
+		    tailleGoban_ * tailleGoban_, 0);
+		travailleurs_[t]->nbPossessions = 0;
+	    }
+	}
+
+	// la racine est développée d'emblée pour que tous les threads
+	// partent de ses enfants
+	if (!arbre_.noeud(arbre_.racine()).developpe()) {
+	    developper(arbre_.racine(), racine_, tourNoir_,
+		       travailleurs_[0]->coups);
+	}
+    }
+
+    void
+    Recherche::simuler(int nbSimulations)
+    {
+	arreter();
+	restantes_.store(nbSimulations);
+
+	// le thread appelant participe à la recherche
+	for (int t = 1; t < parametres_.nbThreads; ++t) {
+	    threads_.push_back(std::thread(&Recherche::travailler, this,
+					   std::ref(*travailleurs_[t])));
+	}
+	travailler(*travailleurs_[0]);
+	attendre();
+    }
+
+    int
+    Recherche::simulerPendant(double budget, double limite)
+    {
+	arreter();
+	restantes_.store(INT_MAX);
+
+	for (int t = 1; t < parametres_.nbThreads; ++t) {
+	    threads_.push_back(std::thread(&Recherche::travailler, this,
+					   std::ref(*travailleurs_[t])));
+	}
+
+	// le thread appelant simule par lots et surveille le temps
+	// entre deux lots
+	const int TAILLE_LOT = 16;
+	const Noeud& racine = arbre_.noeud(arbre_.racine());
+	int visitesDepart = racine.visites.load(std::memory_order_relaxed);
+	std::chrono::steady_clock::time_point debut =
+	    std::chrono::steady_clock::now();
+	for (;;) {
+	    for (int s = 0; s < TAILLE_LOT; ++s) {
+		simulation(*travailleurs_[0]);
+	    }
+
+	    std::chrono::duration<double> duree =
+		std::chrono::steady_clock::now() - debut;
+	    double ecoule = duree.count();
+	    if (ecoule >= limite) {
+		break;
+	    }
+
+	    // nombre de simulations attendues d'ici la fin du budget
+	    int nbSimulations =
+		racine.visites.load(std::memory_order_relaxed) - visitesDepart;
+	    double restantes = ecoule < budget
+		? nbSimulations * (budget - ecoule) / ecoule : 0;
+	    if (!indecis((int) restantes) &&
+		(ecoule >= budget || restantes > 0)) {
+		break;
+	    }
+	}
+
+	arreter();
+	return racine.visites.load(std::memory_order_relaxed) - visitesDepart;
+    }
+
+    bool
+    Recherche::indecis(int nbSimulations) const
+    {
+	const Noeud& racine = arbre_.noeud(arbre_.racine());
+	int debut = racine.premierEnfant;
+	int fin = racine.premierEnfant + racine.nbEnfants;
+
+	int premier = 0;
+	int second = 0;
+	for (int e = debut; e < fin; ++e) {
+	    int visites = arbre_.noeud(e).visites.load(
+		std::memory_order_relaxed);
+	    if (visites > premier) {
+		second = premier;
+		premier = visites;
+	    }
+	    else if (visites > second) {
+		second = visites;
+	    }
+	}
+
+	if (nbSimulations > 0) {
+	    // pendant le budget, le meilleur coup peut-il changer ?
+	    return premier - second <= nbSimulations;
+	}
+
+	// après le budget, la position est indécise si le second
+	// coup talonne le premier, ou si un coup assez visité est
+	// mieux évalué que le plus visité
+	if (second * 10 > premier * 9) {
+	    return true;
+	}
+	double tauxPremier = -1;
+	double tauxMax = -1;
+	for (int e = debut; e < fin; ++e) {
+	    const Noeud& enfant = arbre_.noeud(e);
+	    int visites = enfant.visites.load(std::memory_order_relaxed);
+	    if (visites == premier && tauxPremier < 0) {
+		tauxPremier = enfant.tauxVictoire();
+	    }
+	    if (visites * 4 >= premier && enfant.tauxVictoire() > tauxMax) {
+		tauxMax = enfant.tauxVictoire();
+	    }
+	}
+	return tauxMax > tauxPremier;
+    }
+
+    void
+    Recherche::demarrer(int nbSimulations)
+    {
+	arreter();
+	restantes_.store(nbSimulations);
+
+	for (int t = 0; t < parametres_.nbThreads; ++t) {
+	    threads_.push_back(std::thread(&Recherche::travailler, this,
+					   std::ref(*travailleurs_[t])));
+	}
+    }
+
+    void
+    Recherche::arreter()
+    {
+	// chaque thread termine sa simulation en cours
+	restantes_.store(0);
+	attendre();
+    }
+
+    void
+    Recherche::attendre()
+    {
+	std::vector<std::thread>::iterator it;
+	for (it = threads_.begin(); it != threads_.end(); ++it) {
+	    it->join();
+	}
+	threads_.clear();
+    }
+
+    void
+    Recherche::travailler(Travailleur& travailleur)
+    {
+	while (restantes_.fetch_sub(1, std::memory_order_relaxed) > 0) {
+	    simulation(travailleur);
+	}
+    }
+
+    void
+    Recherche::simulation(Travailleur& travailleur)
+    {
+	jeu::EtatGoban& etat = travailleur.etat;
+	std::vector<int>& chemin = travailleur.chemin;
+	std::vector<uint64_t>& cles = travailleur.cles;
+	etat = racine_;
+	chemin.clear();
+	cles.clear();
+
+	int n = arbre_.racine();
+	bool tourNoir = tourNoir_;
+	bool passe = passeRacine_;
+	bool finie = false;
+	arbre_.noeud(n).visites.fetch_add(1, std::memory_order_relaxed);
+	chemin.push_back(n);
+
+	// descente dans l'arbre ; la visite est comptée dès maintenant
+	while (!finie) {
+	    const Noeud& noeud = arbre_.noeud(n);
+	    if (!noeud.developpe()) {
+		// le décompte des visites inclut la simulation en cours
+		if (noeud.visites.load(std::memory_order_relaxed)
+		    <= parametres_.seuilDeveloppement ||
+		    !developper(n, etat, tourNoir, travailleur.coups)) {
+		    break;
+		}
+	    }
+
+	    n = selectionner(n, travailleur.generateur);
+	    const jeu::Coup& coup = arbre_.noeud(n).coup;
+	    if (coup.type == jeu::TC_POSER) {
+		etat.poser(coup.intersection, tourNoir);
+		passe = false;
+	    }
+	    else {
+		etat.passer();
+		finie = passe;
+		passe = true;
+	    }
+	    tourNoir = !tourNoir;
+
+	    // les positions symétriques partagent leur entrée
+	    uint64_t cle = etat.hashCanonique(tourNoir);
+	    visiter(n, cle);
+	    chemin.push_back(n);
+	    cles.push_back(cle);
+	}
+
+	// fin de la partie par une simulation aléatoire, sauf si les
+	// deux joueurs viennent de passer
+	int delta;
+	if (finie) {
+	    jeu::Score score = etat.scoreSurface();
+	    delta = score.noir - score.blanc;
+	}
+	else {
+	    const jeu::Coup& dernier = chemin.size() > 1
+		? arbre_.noeud(chemin.back()).coup : dernierCoupRacine_;
+	    delta = travailleur.playout.jouer(etat, tourNoir, dernier);
+	}
+	bool simulee = !finie;
+	int demiVictoiresNoir = delta > 0 ? 2 : (delta < 0 ? 0 : 1);
+	if (parametres_.possession) {
+	    compterPossession(travailleur,
+			      simulee ? travailleur.playout.etat() : etat);
+	}
+
+	// remontée du résultat : le coup d'un nœud a été joué par le
+	// joueur ayant le trait à son parent
+	bool joueurNoir = !tourNoir_;
+	for (int i = 0; i < (int) chemin.size(); ++i) {
+	    int d = joueurNoir ? demiVictoiresNoir : 2 - demiVictoiresNoir;
+	    if (d > 0) {
+		arbre_.noeud(chemin[i]).demiVictoires.fetch_add(
+		    d, std::memory_order_relaxed);
+		// la racine n'est pas dans la table
+		if (i > 0) {
+		    transpositions_.ajouterVictoires(cles[i - 1], d);
+		}
+	    }
+	    joueurNoir = !joueurNoir;
+	}
+
+	if (parametres_.rave) {
+	    std::vector<jeu::Coup>& sequence = travailleur.sequence;
+	    sequence.clear();
+	    for (int i = 1; i < (int) chemin.size(); ++i) {
+		sequence.push_back(arbre_.noeud(chemin[i]).coup);
+	    }
+	    if (simulee) {
+		const std::vector<jeu::Coup>& coups =
+		    travailleur.playout.coups();
+		sequence.insert(sequence.end(), coups.begin(), coups.end());
+	    }
+	    mettreAJourAmaf(travailleur, demiVictoiresNoir);
+	}
+    }
+
+    void
+    Recherche::mettreAJourAmaf(Travailleur& travailleur,
+			       int demiVictoiresNoir)
+    {
+	const std::vector<int>& chemin = travailleur.chemin;
+	const std::vector<jeu::Coup>& sequence = travailleur.sequence;
+	std::vector<signed char>& premiers = travailleur.premiers;
+	int taille = racine_.goban().taille();
+	premiers.assign(taille * taille, -1);
+
+	// la séquence est parcourue à rebours : arrivé au coup s, le
+	// tableau indique qui a joué le premier sur chaque
+	// intersection à partir de ce coup, et le coup s est celui
+	// joué depuis le nœud chemin[s]
+	int nbParents = chemin.size() - 1;
+	for (int s = sequence.size() - 1; s >= 0; --s) {
+	    bool noir = (s % 2 == 0) == tourNoir_;
+	    const jeu::Coup& coup = sequence[s];
+	    if (coup.type == jeu::TC_POSER) {
+		premiers[coup.intersection.i + taille * coup.intersection.j]
+		    = noir;
+	    }
+	    if (s >= nbParents) {
+		continue;
+	    }
+
+	    int d = noir ? demiVictoiresNoir : 2 - demiVictoiresNoir;
+	    const Noeud& parent = arbre_.noeud(chemin[s]);
+	    for (int e = parent.premierEnfant;
+		 e < parent.premierEnfant + parent.nbEnfants; ++e) {
+		Noeud& enfant = arbre_.noeud(e);
+		const jeu::Intersection& inter = enfant.coup.intersection;
+		if (enfant.coup.type == jeu::TC_POSER &&
+		    premiers[inter.i + taille * inter.j] == noir) {
+		    enfant.visitesAmaf.fetch_add(1, std::memory_order_relaxed);
+		    if (d > 0) {
+			enfant.demiVictoiresAmaf.fetch_add(
+			    d, std::memory_order_relaxed);
+		    }
+		}
+	    }
+	}
+    }
+
+    void
+    Recherche::visiter(int n, uint64_t cle)
+    {
+	Noeud& noeud = arbre_.noeud(n);
+	noeud.visites.fetch_add(1, std::memory_order_relaxed);
+
+	// les statistiques de la table sont gardées à part, pour que
+	// les visites d'un nœud ne dépassent pas celles de son
+	// parent ; une écriture concurrente perdue ici sera reprise
+	// au passage suivant
+	Transpositions::Statistiques statistiques;
+	if (transpositions_.visiter(cle, statistiques)) {
+	    noeud.visitesTransposition.store(statistiques.visites,
+					     std::memory_order_relaxed);
+	    noeud.demiVictoiresTransposition.store(
+		statistiques.demiVictoires, std::memory_order_relaxed);
+	}
+    }
+
+    int
+    Recherche::selectionner(int n, jeu::Generateur& generateur) const
+    {
+	const Noeud& parent = arbre_.noeud(n);
+	double logVisites = std::log(
+	    (double) parent.visites.load(std::memory_order_relaxed) + 1);
+
+	int meilleur = parent.premierEnfant;
+	double meilleureValeur = -1;
+	for (int e = parent.premierEnfant;
+	     e < parent.premierEnfant + parent.nbEnfants; ++e) {
+	    const Noeud& enfant = arbre_.noeud(e);
+	    int visites = enfant.visites.load(std::memory_order_relaxed);
+
+	    int visitesAmaf = parametres_.rave
+		? enfant.visitesAmaf.load(std::memory_order_relaxed) : 0;
+
+	    // les enfants jamais visités passent en premier, dans un
+	    // ordre aléatoire, sauf si leurs statistiques AMAF
+	    // permettent déjà de les estimer
+	    if (visites == 0 && visitesAmaf == 0) {
+		double valeur = 10 + generateur.reel();
+		if (valeur > meilleureValeur) {
+		    meilleureValeur = valeur;
+		    meilleur = e;
+		}
+		continue;
+	    }
+
+	    // le taux de la table, qui comprend les simulations du
+	    // nœud, le remplace lorsqu'il repose sur plus de visites ;
+	    // le terme d'exploration reste celui du nœud
+	    double valeur = 0;
+	    int visitesTransposition = enfant.visitesTransposition.load(
+		std::memory_order_relaxed);
+	    if (visitesTransposition > visites) {
+		valeur = enfant.demiVictoiresTransposition.load(
+		    std::memory_order_relaxed) / (2.0 * visitesTransposition);
+	    }
+	    else if (visites > 0) {
+		valeur = enfant.demiVictoires.load(std::memory_order_relaxed)
+		    / (2.0 * visites);
+	    }
+	    if (visitesAmaf > 0) {
+		double amaf = enfant.demiVictoiresAmaf.load(
+		    std::memory_order_relaxed) / (2.0 * visitesAmaf);
+		double beta = std::sqrt(parametres_.equivalenceRave
+					/ (3 * visites
+					   + parametres_.equivalenceRave));
+		valeur = (1 - beta) * valeur + beta * amaf;
+	    }
+
+	    // le même coefficient d'exploration s'applique à tous les
+	    // enfants, y compris ceux sans statistiques AMAF comme le
+	    // passe
+	    double exploration = parametres_.rave
+		? parametres_.explorationRave : parametres_.exploration;
+	    valeur += exploration
+		* std::sqrt(logVisites / (visites > 0 ? visites : 1));
+
+	    if (valeur > meilleureValeur) {
+		meilleureValeur = valeur;
+		meilleur = e;
+	    }
+	}
+	return meilleur;
+    }
+
+    bool
+    Recherche::developper(int n, const jeu::EtatGoban& etat, bool tourNoir,
+			  std::vector<jeu::Coup>& coups)
+    {
+	// les coups bouchant un œil du joueur ne sont pas envisagés
+	coups.clear();
+	std::vector<jeu::Intersection> licites = etat.coupsLicites(tourNoir);
+	std::vector<jeu::Intersection>::const_iterator it;
+	for (it = licites.begin(); it != licites.end(); ++it) {
+	    if (!etat.oeil(*it, tourNoir)) {
+		coups.push_back(jeu::Coup(*it));
+	    }
+	}
+
+	jeu::Coup passer;
+	passer.type = jeu::TC_PASSER;
+	coups.push_back(passer);
+
+	return arbre_.developper(n, coups);
+    }
+
+    int
+    Recherche::enfant(const jeu::Coup& coup) const
+    {
+	const Noeud& racine = arbre_.noeud(arbre_.racine());
+	if (!racine.developpe()) {
+	    return -1;
+	}
+	for (int e = racine.premierEnfant;
+	     e < racine.premierEnfant + racine.nbEnfants; ++e) {
+	    if (arbre_.noeud(e).coup == coup) {
+		return e;
+	    }
+	}
+	return -1;
+    }
+
+    void
+    Recherche::compterPossession(Travailleur& travailleur,
+				 const jeu::EtatGoban& etat) const
+    {
+	// une intersection vide appartient au joueur dont elle n'est
+	// entourée que par des pierres, ce qui suffit en fin de
+	// simulation où les zones vides sont presque toutes isolées
+	int taille = tailleGoban_;
+	std::vector<int>& possession = travailleur.possession;
+	for (int id = 0; id < taille * taille; ++id) {
+	    jeu::Intersection inter(id % taille, id / taille);
+	    jeu::EtatIntersection couleur = etat.etat(inter);
+	    if (couleur == jeu::EI_VIDE) {
+		bool noir = false;
+		bool blanc = false;
+		const int di[] = {-1, 1, 0, 0};
+		const int dj[] = {0, 0, -1, 1};
+		for (int d = 0; d < 4; ++d) {
+		    jeu::Intersection voisin(inter.i + di[d], inter.j + dj[d]);
+		    if (voisin.i < 0 || voisin.i >= taille ||
+			voisin.j < 0 || voisin.j >= taille) {
+			continue;
+		    }
+		    noir = noir || etat.etat(voisin) == jeu::EI_NOIR;
+		    blanc = blanc || etat.etat(voisin) == jeu::EI_BLANC;
+		}
+		couleur = noir == blanc ? jeu::EI_VIDE
+		    : (noir ? jeu::EI_NOIR : jeu::EI_BLANC);
+	    }
+	    if (couleur == jeu::EI_NOIR) {
+		++possession[id];
+	    }
+	    else if (couleur == jeu::EI_BLANC) {
+		--possession[id];
+	    }
+	}
+	++travailleur.nbPossessions;
+    }
+
+    jeu::Coup
+    Recherche::meilleurCoup(const std::vector<jeu::Coup>& exclus) const
+    {
+	jeu::Coup coup;
+	coup.type = jeu::TC_PASSER;
+
+	const Noeud& racine = arbre_.noeud(arbre_.racine());
+	if (!racine.developpe()) {
+	    return coup;
+	}
+
+	int visitesMax = -1;
+	for (int e = racine.premierEnfant;
+	     e < racine.premierEnfant + racine.nbEnfants; ++e) {
+	    const Noeud& enfant = arbre_.noeud(e);
+	    int visites = enfant.visites.load(std::memory_order_relaxed);
+	    if (visites > visitesMax &&
+		std::find(exclus.begin(), exclus.end(), enfant.coup)
+		== exclus.end()) {
+		visitesMax = visites;
+		coup = enfant.coup;
+	    }
+	}
+	return coup;
+    }
+
+    double
+    Recherche::tauxVictoire(const jeu::Coup& coup) const
+    {
+	int e = enfant(coup);
+	if (e < 0) {
+	    return 0.5;
+	}
+	return arbre_.noeud(e).tauxVictoire();
+    }
+
+
+    void
+    Recherche::possession(std::vector<double>& possession) const
+    {
+	possession.clear();
+	if (!parametres_.possession) {
+	    return;
+	}
+	possession.assign(tailleGoban_ * tailleGoban_, 0);
+	int nbPossessions = 0;
+	for (int t = 0; t < parametres_.nbThreads; ++t) {
+	    const Travailleur& travailleur = *travailleurs_[t];
+	    for (unsigned int id = 0; id < travailleur.possession.size(); ++id) {
+		possession[id] += travailleur.possession[id];
+	    }
+	    nbPossessions += travailleur.nbPossessions;
+	}
+	if (nbPossessions > 0) {
+	    for (unsigned int id = 0; id < possession.size(); ++id) {
+		possession[id] /= nbPossessions;
+	    }
+	}
+    }
+
+}
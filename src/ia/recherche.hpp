@@ -0,0 +1,483 @@
+#ifndef IA_RECHERCHE_HPP
+#define IA_RECHERCHE_HPP
+
+#include <vector> // std::vector
+#include <atomic> // std::atomic
+#include <thread> // std::thread
+
+#include <jeu/types.hpp> // jeu::Coup
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/generateur.hpp> // jeu::Generateur
+
+#include <ia/arbre.hpp> // ia::Arbre
+#include <ia/playout.hpp> // ia::Playout
+#include <ia/transpositions.hpp> // ia::Transpositions
+
+namespace ia {
+
+    /**
+     * \brief Structure regroupant les paramètres de la recherche.
+     */
+    struct Parametres {
+
+	/**
+	 * \brief Nombre de simulations par coup.
+	 */
+	int nbSimulations;
+
+	/**
+	 * \brief Coefficient d'exploration de la formule UCB.
+	 */
+	double exploration;
+
+	/**
+	 * \brief Utilisation des statistiques AMAF dans la sélection
+	 *        (RAVE).
+	 */
+	bool rave;
+
+	/**
+	 * \brief Nombre de visites d'un nœud pour lequel ses
+	 *        statistiques propres et ses statistiques AMAF ont le
+	 *        même poids.
+	 */
+	double equivalenceRave;
+
+	/**
+	 * \brief Coefficient d'exploration utilisé avec RAVE.
+	 */
+	double explorationRave;
+
+	/**
+	 * \brief Utilisation des heuristiques locales (captures,
+	 *        fuites, motifs 3x3) dans les simulations.
+	 *
+	 * Elles sont désactivées par défaut : elles divisent à peu
+	 * près par deux le débit des simulations, sans gain de force
+	 * mesuré à nombre de simulations égal.
+	 */
+	bool heuristiques;
+
+	/**
+	 * \brief Nombre de visites d'une feuille avant son
+	 *        développement.
+	 */
+	int seuilDeveloppement;
+
+	/**
+	 * \brief Nombre de threads effectuant les simulations.
+	 */
+	int nbThreads;
+
+	/**
+	 * \brief Réflexion pendant le tour de l'adversaire.
+	 */
+	bool reflexion;
+
+	/**
+	 * \brief Nombre maximal de simulations effectuées pendant un
+	 *        tour de l'adversaire.
+	 */
+	int nbSimulationsReflexion;
+
+	/**
+	 * \brief Marge de sécurité, en secondes, laissée sur le temps
+	 *        disponible pour un coup.
+	 */
+	double margeTemps;
+
+	/**
+	 * \brief Nombre maximal de nœuds de l'arbre.
+	 */
+	int capaciteArbre;
+
+	/**
+	 * \brief Taille de la table de transposition, en Mo ; une
+	 *        taille nulle la désactive.
+	 */
+	int tailleTranspositions;
+
+	/**
+	 * \brief Affichage des statistiques de chaque coup sur la
+	 *        sortie d'erreur.
+	 */
+	bool messages;
+
+	/**
+	 * \brief Estimation de la possession de chaque intersection
+	 *        à la fin des simulations.
+	 */
+	bool possession;
+
+	/**
+	 * \brief Constructeur des paramètres par défaut.
+	 *
+	 * Par défaut, un thread est utilisé par cœur de la machine.
+	 */
+	Parametres();
+
+    };
+
+    /**
+     * \brief Classe de recherche arborescente Monte-Carlo (UCT).
+     *
+     * Chaque simulation descend l'arbre en choisissant à chaque
+     * nœud l'enfant maximisant la borne UCB1, développe la feuille
+     * atteinte si elle a été assez visitée, termine la partie par
+     * une simulation aléatoire puis remonte le résultat, victoire
+     * ou défaite, le long du chemin suivi.
+     *
+     * Les simulations sont réparties entre plusieurs threads qui
+     * partagent le même arbre. La visite d'un nœud est comptée dès
+     * la descente et la victoire éventuelle seulement à la
+     * remontée : une simulation en cours compte donc comme une
+     * défaite (perte virtuelle), ce qui incite les autres threads à
+     * explorer d'autres branches en attendant son résultat. Chaque
+     * thread dispose de son propre générateur et de ses propres
+     * états de travail.
+     *
+     * Une position atteinte par plusieurs ordres de coups, ou
+     * symétrique d'une autre, correspond à plusieurs nœuds de
+     * l'arbre. Leurs statistiques sont mises en commun par une
+     * table de transposition indexée par la forme canonique des
+     * positions : chaque passage par un nœud y est aussi compté.
+     * Lorsque la table est plus fournie que le nœud, son taux de
+     * victoire remplace celui du nœud dans la valeur de sélection,
+     * mais les visites du nœud, qui servent au terme d'exploration
+     * et au choix du coup, restent les siennes. La table est
+     * conservée d'un coup à l'autre.
+     *
+     * Si RAVE est activé, chaque simulation met aussi à jour,
+     * pour chaque nœud du chemin, les statistiques AMAF de tous
+     * ses enfants dont le coup a été joué plus loin dans la
+     * simulation par le même joueur. La valeur d'un enfant est
+     * alors un mélange de ses deux taux de victoire, le poids des
+     * statistiques AMAF décroissant avec le nombre de visites.
+     */
+    class Recherche {
+
+    public:
+
+	/**
+	 * \brief Constructeur de recherche.
+	 *
+	 * Le générateur passé en paramètre sert à initialiser ceux
+	 * des threads.
+	 */
+	Recherche(const Parametres& parametres, jeu::Generateur& generateur);
+
+	/**
+	 * \brief Destructeur de recherche.
+	 */
+	~Recherche();
+
+	/**
+	 * \brief Initialisation de la recherche depuis un état.
+	 *
+	 * Le dernier coup permet de savoir si un passe terminerait
+	 * la partie.
+	 */
+	void
+	initialiser(const jeu::EtatGoban& etat, bool tourNoir,
+		    const jeu::Coup& dernierCoup);
+
+	/**
+	 * \brief Oubli des recherches précédentes, arbre et table de
+	 *        transposition compris.
+	 *
+	 * Une recherche initialisée ensuite ne profite pas des
+	 * statistiques des positions déjà recherchées, ce qui la rend
+	 * indépendante des précédentes.
+	 */
+	void
+	vider();
+
+	/**
+	 * \brief Passage à la position suivante de la partie en
+	 *        conservant l'arbre.
+	 *
+	 * Si la position passée en paramètre est celle obtenue en
+	 * jouant le dernier coup depuis la racine, l'enfant
+	 * correspondant devient la racine et ses statistiques sont
+	 * conservées ; le reste de l'arbre est libéré. Si c'est la
+	 * position de la racine, l'arbre est gardé tel quel. Sinon, la
+	 * recherche est initialisée depuis cette position. La valeur
+	 * de retour indique si l'arbre a été conservé.
+	 */
+	bool
+	avancer(const jeu::EtatGoban& etat, bool tourNoir,
+		const jeu::Coup& dernierCoup);
+
+	/**
+	 * \brief Exécution de simulations, réparties entre les
+	 *        threads.
+	 */
+	void
+	simuler(int nbSimulations);
+
+	/**
+	 * \brief Exécution de simulations pendant une durée donnée.
+	 *
+	 * La recherche dure normalement le budget passé en paramètre,
+	 * en secondes. Elle s'arrête plus tôt si le coup le plus
+	 * visité ne peut plus changer avant la fin du budget, compte
+	 * tenu du rythme des simulations, et se prolonge jusqu'à la
+	 * limite si la position reste indécise : coup le plus visité
+	 * qui n'est pas le mieux évalué, ou talonné par le second. La
+	 * limite n'est jamais dépassée de plus d'un lot de
+	 * simulations. La valeur de retour est le nombre de
+	 * simulations effectuées.
+	 */
+	int
+	simulerPendant(double budget, double limite);
+
+	/**
+	 * \brief Lancement de simulations en arrière-plan.
+	 *
+	 * Tous les threads de la recherche simulent jusqu'à avoir
+	 * effectué le nombre de simulations demandé ou jusqu'à
+	 * l'appel de arreter(). L'appelant reprend la main
+	 * immédiatement ; il ne doit pas accéder à l'arbre avant
+	 * d'avoir arrêté la recherche.
+	 */
+	void
+	demarrer(int nbSimulations);
+
+	/**
+	 * \brief Arrêt des simulations en arrière-plan.
+	 *
+	 * La fonction rend la main une fois les simulations en cours
+	 * terminées. Elle est appelée automatiquement par toutes les
+	 * méthodes qui modifient la racine.
+	 */
+	void
+	arreter();
+
+	/**
+	 * \brief Coup le plus visité depuis la racine.
+	 *
+	 * Les coups de la liste d'exclusion, par exemple ceux déjà
+	 * refusés par la partie, sont ignorés. Si aucun coup ne
+	 * convient, le coup retourné consiste à passer.
+	 */
+	jeu::Coup
+	meilleurCoup(const std::vector<jeu::Coup>& exclus) const;
+
+	/**
+	 * \brief Taux de victoire estimé d'un coup de la racine pour
+	 *        le joueur qui a le trait.
+	 */
+	double
+	tauxVictoire(const jeu::Coup& coup) const;
+
+	/**
+	 * \brief Possession moyenne de chaque intersection à la fin
+	 *        des simulations.
+	 *
+	 * La possession va de -1 pour blanc à 1 pour noir, pierres et
+	 * territoire confondus ; elle est indexée par
+	 * jeu::Goban::id() et porte sur les simulations effectuées
+	 * depuis la dernière mise en place de la racine. Le vecteur
+	 * est vide si l'estimation n'est pas activée dans les
+	 * paramètres.
+	 */
+	void
+	possession(std::vector<double>& possession) const;
+
+	/**
+	 * \brief Accès aux paramètres.
+	 */
+	inline
+	const Parametres&
+	parametres() const
+	{
+	    return parametres_;
+	}
+
+	/**
+	 * \brief Accès à l'arbre de recherche.
+	 */
+	inline
+	const Arbre&
+	arbre() const
+	{
+	    return arbre_;
+	}
+
+    private:
+
+	/**
+	 * \brief Données propres à un thread de recherche.
+	 */
+	struct Travailleur {
+
+	    jeu::Generateur generateur;
+
+	    Playout playout;
+
+	    /**
+	     * \brief État de travail d'une simulation.
+	     */
+	    jeu::EtatGoban etat;
+
+	    /**
+	     * \brief Chemin suivi par une simulation.
+	     */
+	    std::vector<int> chemin;
+
+	    /**
+	     * \brief Hash des positions du chemin, trait compris.
+	     */
+	    std::vector<uint64_t> cles;
+
+	    /**
+	     * \brief Coups de la simulation depuis la racine, arbre et
+	     *        simulation aléatoire confondus.
+	     */
+	    std::vector<jeu::Coup> sequence;
+
+	    /**
+	     * \brief Pour chaque intersection, couleur du premier
+	     *        joueur à y avoir joué depuis un point de la
+	     *        séquence, ou -1.
+	     */
+	    std::vector<signed char> premiers;
+
+	    /**
+	     * \brief Coups possibles lors d'un développement.
+	     */
+	    std::vector<jeu::Coup> coups;
+
+	    /**
+	     * \brief Somme des possessions de chaque intersection à la
+	     *        fin des simulations du thread, et nombre de ces
+	     *        simulations.
+	     */
+	    std::vector<int> possession;
+	    int nbPossessions;
+
+	    Travailleur(uint64_t graine, bool heuristiques);
+
+	};
+
+	Recherche(const Recherche&);
+
+	Recherche& operator=(const Recherche&);
+
+	/**
+	 * \brief Mise en place de la racine, l'arbre étant déjà
+	 *        vidé ou réduit au sous-arbre de la position.
+	 */
+	void
+	preparer(const jeu::EtatGoban& etat, bool tourNoir,
+		 const jeu::Coup& dernierCoup);
+
+	/**
+	 * \brief Savoir si le coup le plus visité de la racine peut
+	 *        encore être dépassé par un autre en un nombre donné de
+	 *        simulations.
+	 */
+	bool
+	indecis(int nbSimulations) const;
+
+	/**
+	 * \brief Attente de la fin des threads lancés.
+	 */
+	void
+	attendre();
+
+	/**
+	 * \brief Boucle de simulation d'un thread.
+	 */
+	void
+	travailler(Travailleur& travailleur);
+
+	/**
+	 * \brief Exécution d'une simulation.
+	 */
+	void
+	simulation(Travailleur& travailleur);
+
+	/**
+	 * \brief Comptage d'une visite d'un nœud, dans l'arbre et
+	 *        dans la table de transposition.
+	 */
+	void
+	visiter(int n, uint64_t cle);
+
+	/**
+	 * \brief Mise à jour des statistiques AMAF le long du chemin
+	 *        d'une simulation.
+	 */
+	void
+	mettreAJourAmaf(Travailleur& travailleur, int demiVictoiresNoir);
+
+	/**
+	 * \brief Comptage de la possession des intersections à la fin
+	 *        d'une simulation.
+	 */
+	void
+	compterPossession(Travailleur& travailleur,
+			  const jeu::EtatGoban& etat) const;
+
+	/**
+	 * \brief Choix de l'enfant maximisant la borne UCB1.
+	 */
+	int
+	selectionner(int n, jeu::Generateur& generateur) const;
+
+	/**
+	 * \brief Développement d'un nœud pour l'état atteint.
+	 */
+	bool
+	developper(int n, const jeu::EtatGoban& etat, bool tourNoir,
+		   std::vector<jeu::Coup>& coups);
+
+	/**
+	 * \brief Enfant de la racine correspondant à un coup, ou -1.
+	 */
+	int
+	enfant(const jeu::Coup& coup) const;
+
+	Parametres parametres_;
+
+	Arbre arbre_;
+
+	Transpositions transpositions_;
+
+	/**
+	 * \brief État à la racine de l'arbre.
+	 */
+	jeu::EtatGoban racine_;
+
+	/**
+	 * \brief Taille du goban de la dernière recherche.
+	 */
+	int tailleGoban_;
+
+	bool tourNoir_;
+
+	bool passeRacine_;
+
+	/**
+	 * \brief Dernier coup joué avant la position de la racine.
+	 */
+	jeu::Coup dernierCoupRacine_;
+
+	std::vector<Travailleur*> travailleurs_;
+
+	/**
+	 * \brief Threads en cours d'exécution.
+	 */
+	std::vector<std::thread> threads_;
+
+	/**
+	 * \brief Nombre de simulations restant à distribuer.
+	 */
+	std::atomic<int> restantes_;
+
+    };
+
+}
+
+#endif
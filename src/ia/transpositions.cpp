@@ -0,0 +1,133 @@
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+#include <ia/transpositions.hpp>
+
+namespace ia {
+
+    Transpositions::Transpositions(std::size_t taille)
+	: entrees_(),
+	  verrous_(NB_VERROUS),
+	  masque_(0),
+	  generation_(0)
+    {
+	std::size_t nbSeaux = taille / (NB_VOIES * sizeof(Entree));
+	if (nbSeaux > 0) {
+	    std::size_t puissance = 1;
+	    while (puissance * 2 <= nbSeaux) {
+		puissance *= 2;
+	    }
+	    entrees_.resize(puissance * NB_VOIES);
+	    masque_ = puissance - 1;
+	}
+	vider();
+    }
+
+    void
+    Transpositions::vider()
+    {
+	std::vector<Entree>::iterator it;
+	for (it = entrees_.begin(); it != entrees_.end(); ++it) {
+	    it->cle = 0;
+	    it->visites = 0;
+	    it->demiVictoires = 0;
+	    it->generation = 0;
+	}
+	generation_ = 0;
+    }
+
+    void
+    Transpositions::nouvelleRecherche()
+    {
+	++generation_;
+    }
+
+    bool
+    Transpositions::visiter(uint64_t hash, Statistiques& statistiques)
+    {
+	if (!active()) {
+	    return false;
+	}
+
+	uint64_t c = cle(hash);
+	int s = seau(c);
+	std::lock_guard<std::mutex> verrou(verrous_[s % NB_VERROUS]);
+
+	// recherche de la position, en retenant l'entrée à remplacer
+	// si elle est absente
+	Entree* entrees = &entrees_[s * NB_VOIES];
+	Entree* remplacee = entrees;
+	for (int v = 0; v < NB_VOIES; ++v) {
+	    Entree& e = entrees[v];
+	    if (e.cle == c) {
+		e.generation = generation_;
+		++e.visites;
+		statistiques.visites = e.visites;
+		statistiques.demiVictoires = e.demiVictoires;
+		return true;
+	    }
+
+	    if (v > 0 && remplacer(e, *remplacee)) {
+		remplacee = &e;
+	    }
+	}
+
+	remplacee->cle = c;
+	remplacee->visites = 1;
+	remplacee->demiVictoires = 0;
+	remplacee->generation = generation_;
+	statistiques.visites = 1;
+	statistiques.demiVictoires = 0;
+	return true;
+    }
+
+    void
+    Transpositions::ajouterVictoires(uint64_t hash, int demiVictoires)
+    {
+	if (!active()) {
+	    return;
+	}
+
+	uint64_t c = cle(hash);
+	int s = seau(c);
+	std::lock_guard<std::mutex> verrou(verrous_[s % NB_VERROUS]);
+
+	Entree* entrees = &entrees_[s * NB_VOIES];
+	for (int v = 0; v < NB_VOIES; ++v) {
+	    if (entrees[v].cle == c) {
+		entrees[v].demiVictoires += demiVictoires;
+		return;
+	    }
+	}
+    }
+
+    bool
+    Transpositions::remplacer(const Entree& e1, const Entree& e2) const
+    {
+	if ((e1.cle == 0) != (e2.cle == 0)) {
+	    return e1.cle == 0;
+	}
+	bool ancienne1 = e1.generation != generation_;
+	bool ancienne2 = e2.generation != generation_;
+	if (ancienne1 != ancienne2) {
+	    return ancienne1;
+	}
+	return e1.visites < e2.visites;
+    }
+
+    int
+    Transpositions::nbOccupees() const
+    {
+	int n = 0;
+	std::vector<Entree>::const_iterator it;
+	for (it = entrees_.begin(); it != entrees_.end(); ++it) {
+	    if (it->cle != 0) {
+		++n;
+	    }
+	}
+	return n;
+    }
+
+}
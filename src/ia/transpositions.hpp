@@ -0,0 +1,195 @@
+#ifndef IA_TRANSPOSITIONS_HPP
+#define IA_TRANSPOSITIONS_HPP
+
+#include <cstddef> // std::size_t
+#include <stdint.h> // uint64_t
+#include <vector> // std::vector
+#include <mutex> // std::mutex
+
+namespace ia {
+
+    /**
+     * \brief Table de transposition partagée par les threads de
+     *        recherche.
+     *
+     * La table associe à une position, identifiée par un hash
+     * Zobrist trait compris, les statistiques de toutes les
+     * simulations qui l'ont traversée, quel que soit l'ordre des
+     * coups qui y a mené. Les victoires sont celles du joueur qui
+     * vient de jouer, comme dans les nœuds de l'arbre.
+     *
+     * La table a une taille fixe, choisie à la construction. Elle
+     * est découpée en seaux de NB_VOIES entrées ; une position ne
+     * peut occuper qu'une entrée de son seau. Lorsqu'une position
+     * absente doit être ajoutée à un seau plein, l'entrée remplacée
+     * est, par ordre de préférence, une entrée laissée par une
+     * recherche précédente, puis l'entrée la moins visitée.
+     *
+     * Les seaux sont protégés par un ensemble de NB_VERROUS
+     * verrous, un seau étant protégé par le verrou de même indice
+     * modulo NB_VERROUS.
+     */
+    class Transpositions {
+
+    public:
+
+	/**
+	 * \brief Statistiques d'une position.
+	 */
+	struct Statistiques {
+
+	    int visites;
+
+	    /**
+	     * \brief Victoires du joueur qui vient de jouer, comptées
+	     *        en demi-victoires.
+	     */
+	    int demiVictoires;
+
+	};
+
+	/**
+	 * \brief Nombre d'entrées par seau.
+	 */
+	static const int NB_VOIES = 2;
+
+	/**
+	 * \brief Nombre de verrous.
+	 */
+	static const int NB_VERROUS = 1024;
+
+	/**
+	 * \brief Constructeur de table occupant au plus le nombre
+	 *        d'octets passé en paramètre.
+	 *
+	 * Le nombre de seaux est arrondi à la puissance de deux
+	 * inférieure. Une taille nulle donne une table désactivée.
+	 */
+	explicit
+	Transpositions(std::size_t taille);
+
+	/**
+	 * \brief Savoir si la table est utilisable.
+	 */
+	inline
+	bool
+	active() const
+	{
+	    return !entrees_.empty();
+	}
+
+	/**
+	 * \brief Effacement de toutes les entrées.
+	 */
+	void
+	vider();
+
+	/**
+	 * \brief Début d'une nouvelle recherche.
+	 *
+	 * Les entrées des recherches précédentes restent lisibles,
+	 * mais seront remplacées en priorité.
+	 */
+	void
+	nouvelleRecherche();
+
+	/**
+	 * \brief Ajout d'une visite à une position.
+	 *
+	 * La position est ajoutée à la table si elle est absente. Les
+	 * statistiques de la position après ajout de la visite sont
+	 * écrites dans le second paramètre. La valeur de retour est
+	 * faux si la table est désactivée.
+	 */
+	bool
+	visiter(uint64_t cle, Statistiques& statistiques);
+
+	/**
+	 * \brief Ajout de demi-victoires à une position.
+	 *
+	 * Rien n'est fait si la position a été remplacée depuis sa
+	 * visite.
+	 */
+	void
+	ajouterVictoires(uint64_t cle, int demiVictoires);
+
+	/**
+	 * \brief Nombre d'entrées de la table.
+	 */
+	inline
+	int
+	nbEntrees() const
+	{
+	    return entrees_.size();
+	}
+
+	/**
+	 * \brief Nombre d'entrées occupées, compté sans verrou.
+	 */
+	int
+	nbOccupees() const;
+
+    private:
+
+	/**
+	 * \brief Entrée de la table.
+	 *
+	 * Une clé nulle désigne une entrée vide.
+	 */
+	struct Entree {
+
+	    uint64_t cle;
+
+	    int visites;
+
+	    int demiVictoires;
+
+	    unsigned generation;
+
+	};
+
+	Transpositions(const Transpositions&);
+
+	Transpositions& operator=(const Transpositions&);
+
+	/**
+	 * \brief Indice du seau d'une clé.
+	 */
+	inline
+	int
+	seau(uint64_t cle) const
+	{
+	    return (cle >> 32 ^ cle) & masque_;
+	}
+
+	/**
+	 * \brief Savoir si la première entrée doit être remplacée
+	 *        plutôt que la seconde.
+	 */
+	bool
+	remplacer(const Entree& e1, const Entree& e2) const;
+
+	/**
+	 * \brief Clé non nulle correspondant à un hash.
+	 */
+	static
+	inline
+	uint64_t
+	cle(uint64_t hash)
+	{
+	    return hash != 0 ? hash : 1;
+	}
+
+	std::vector<Entree> entrees_;
+
+	std::vector<std::mutex> verrous_;
+
+	uint64_t masque_;
+
+	unsigned generation_;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,507 @@
+#include <cmath> // std::floor
+#include <cstddef> // std::size_t
+#include <cstdio> // std::FILE, std::fopen, std::fwrite, std::fseek
+#include <cstdlib> // std::strtod
+#include <cstring> // std::memcpy, std::memcmp
+#include <stdint.h>
+
+#include <sstream> // std::ostringstream
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <jeu/types.hpp>
+#include <jeu/bitboard.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/sgf.hpp>
+
+#include <jeu/archive.hpp>
+
+namespace jeu {
+
+    namespace {
+
+	/**
+	 * \brief Projection d'un fichier en lecture seule, NULL en
+	 *        cas d'échec.
+	 */
+	void*
+	projeter(const std::string& fichier, std::size_t& longueur)
+	{
+	    int fd = open(fichier.c_str(), O_RDONLY);
+	    if (fd < 0) {
+		return NULL;
+	    }
+	    struct stat infos;
+	    if (fstat(fd, &infos) != 0 || infos.st_size == 0) {
+		close(fd);
+		return NULL;
+	    }
+	    longueur = infos.st_size;
+	    void* projection = mmap(NULL, longueur, PROT_READ, MAP_PRIVATE, fd, 0);
+	    // la projection reste valide après la fermeture du fichier
+	    close(fd);
+	    return projection == MAP_FAILED ? NULL : projection;
+	}
+
+    }
+
+    const char Archive::MAGIE[8] = {'K', 'N', 'T', 'K', 'A', 'R', 'C', '1'};
+
+    const char Archive::MAGIE_INDEX[8] = {'K', 'N', 'T', 'K', 'I', 'D', 'X', '1'};
+
+    Archive::Archive()
+	: projection_(NULL),
+	  projectionIndex_(NULL),
+	  longueur_(0),
+	  longueurIndex_(0),
+	  donnees_(NULL),
+	  index_(NULL),
+	  positions_(NULL)
+    {
+    }
+
+    Archive::~Archive()
+    {
+	fermer();
+    }
+
+    bool
+    Archive::ouvrir(const std::string& fichier)
+    {
+	fermer();
+
+	projection_ = projeter(fichier, longueur_);
+	projectionIndex_ = projeter(nomIndex(fichier), longueurIndex_);
+	if (projection_ == NULL || projectionIndex_ == NULL ||
+	    longueur_ < sizeof(MAGIE) || longueurIndex_ < sizeof(EnTeteIndex)) {
+	    fermer();
+	    return false;
+	}
+
+	donnees_ = static_cast<const uint8_t*>(projection_);
+	const EnTeteIndex* index =
+	    static_cast<const EnTeteIndex*>(projectionIndex_);
+	positions_ = reinterpret_cast<const uint64_t*>(index + 1);
+	if (std::memcmp(donnees_, MAGIE, sizeof(MAGIE)) != 0 ||
+	    std::memcmp(index->magie, MAGIE_INDEX, sizeof(MAGIE_INDEX)) != 0 ||
+	    longueurIndex_ != sizeof(EnTeteIndex)
+	    + (index->nbParties + 1) * sizeof(uint64_t) ||
+	    positions_[index->nbParties] != longueur_) {
+	    fermer();
+	    return false;
+	}
+	index_ = index;
+	return true;
+    }
+
+    void
+    Archive::fermer()
+    {
+	if (projection_ != NULL) {
+	    munmap(projection_, longueur_);
+	}
+	if (projectionIndex_ != NULL) {
+	    munmap(projectionIndex_, longueurIndex_);
+	}
+	projection_ = NULL;
+	projectionIndex_ = NULL;
+	longueur_ = 0;
+	longueurIndex_ = 0;
+	donnees_ = NULL;
+	index_ = NULL;
+	positions_ = NULL;
+    }
+
+    void
+    Archive::coderResultat(const std::string& resultat, EnTetePartie& enTete)
+    {
+	enTete.vainqueur = V_INCONNU;
+	enTete.fin = F_INCONNUE;
+	enTete.ecart = 0;
+
+	if (resultat == "0" || resultat == "Draw" || resultat == "Jigo") {
+	    enTete.vainqueur = V_EGALITE;
+	    enTete.fin = F_POINTS;
+	    return;
+	}
+	if (resultat.size() < 2 || resultat[1] != '+' ||
+	    (resultat[0] != 'B' && resultat[0] != 'W')) {
+	    return;
+	}
+	bool noir = resultat[0] == 'B';
+	enTete.vainqueur = noir ? V_NOIR : V_BLANC;
+
+	std::string fin = resultat.substr(2);
+	char* reste;
+	double ecart = std::strtod(fin.c_str(), &reste);
+	if (fin == "R" || fin == "Resign") {
+	    enTete.fin = F_ABANDON;
+	}
+	else if (fin == "T" || fin == "Time") {
+	    enTete.fin = F_TEMPS;
+	}
+	else if (!fin.empty() && *reste == '\0' && ecart > 0 && ecart < 16000) {
+	    enTete.fin = F_POINTS;
+	    enTete.ecart = (noir ? 1 : -1) * (int) std::floor(2 * ecart + 0.5);
+	}
+    }
+
+    std::string
+    Archive::resultat(const EnTetePartie& enTete)
+    {
+	if (enTete.vainqueur == V_EGALITE) {
+	    return "0";
+	}
+	if (enTete.vainqueur != V_NOIR && enTete.vainqueur != V_BLANC) {
+	    return "";
+	}
+	std::ostringstream resultat;
+	resultat << (enTete.vainqueur == V_NOIR ? "B+" : "W+");
+	if (enTete.fin == F_ABANDON) {
+	    resultat << "R";
+	}
+	else if (enTete.fin == F_TEMPS) {
+	    resultat << "T";
+	}
+	else if (enTete.fin == F_POINTS) {
+	    resultat << (enTete.ecart < 0 ? -enTete.ecart : enTete.ecart) / 2.0;
+	}
+	return resultat.str();
+    }
+
+    std::string
+    Archive::nomIndex(const std::string& fichier)
+    {
+	return fichier + ".index";
+    }
+
+    Relecture::Relecture(const Archive& archive)
+	: archive_(archive),
+	  gobans_(),
+	  enTete_(NULL),
+	  etat_(),
+	  tourNoir_(true),
+	  nbCoups_(0),
+	  octet_(NULL),
+	  fin_(NULL),
+	  bits_(0),
+	  nbBits_(0)
+    {
+    }
+
+    bool
+    Relecture::commencer(long n)
+    {
+	enTete_ = NULL;
+	if (n < 0 || n >= archive_.nbParties()) {
+	    return false;
+	}
+	octet_ = archive_.coups(n, fin_);
+	if (fin_ < octet_) {
+	    return false;
+	}
+	const Archive::EnTetePartie& enTete = archive_.enTete(n);
+	if (enTete.taille < 2 || enTete.taille > Bitboard::TAILLE_MAX) {
+	    return false;
+	}
+	enTete_ = &enTete;
+	etat_ = EtatGoban(gobans_.goban(enTete.taille, enTete.komi));
+	tourNoir_ = enTete.premierNoir;
+	nbCoups_ = 0;
+	bits_ = 0;
+	nbBits_ = 0;
+
+	for (int h = 0; h < enTete.handicap; ++h) {
+	    Coup coup;
+	    if (!decoder(coup) || coup.type != TC_POSER ||
+		!etat_.poser(coup.intersection, true)) {
+		return false;
+	    }
+	}
+	return true;
+    }
+
+    bool
+    Relecture::suivant(Coup& coup)
+    {
+	if (enTete_ == NULL || nbCoups_ >= enTete_->nbCoups ||
+	    !decoder(coup)) {
+	    return false;
+	}
+	if (coup.type == TC_POSER) {
+	    if (!etat_.poser(coup.intersection, tourNoir_)) {
+		return false;
+	    }
+	}
+	else {
+	    etat_.passer();
+	}
+	tourNoir_ = !tourNoir_;
+	++nbCoups_;
+	return true;
+    }
+
+    bool
+    Relecture::lire(long n, PartieSgf& partie)
+    {
+	partie.vider();
+	if (!commencer(n)) {
+	    return false;
+	}
+	partie.taille = enTete_->taille;
+	partie.komi = enTete_->komi / 2.0;
+	partie.handicap = enTete_->handicap;
+	partie.premierNoir = enTete_->premierNoir;
+	partie.resultat = Archive::resultat(*enTete_);
+
+	// seules les pierres de handicap sont sur le goban
+	Intersection inter;
+	for (inter.i = 0; inter.i < partie.taille; ++inter.i) {
+	    for (inter.j = 0; inter.j < partie.taille; ++inter.j) {
+		if (etat_.etat(inter) == EI_NOIR) {
+		    partie.noires.push_back(inter);
+		}
+	    }
+	}
+
+	Coup coup;
+	while (suivant(coup)) {
+	    partie.coups.push_back(coup);
+	}
+	return nbCoups_ == enTete_->nbCoups;
+    }
+
+    bool
+    Relecture::decoder(Coup& coup)
+    {
+	int nbVides = etat_.nbVides();
+	int largeur = Archive::largeur(nbVides);
+	while (nbBits_ < largeur) {
+	    if (octet_ == fin_) {
+		return false;
+	    }
+	    bits_ |= (uint64_t) *octet_++ << nbBits_;
+	    nbBits_ += 8;
+	}
+	int rang = bits_ & ((1 << largeur) - 1);
+	bits_ >>= largeur;
+	nbBits_ -= largeur;
+
+	if (rang == nbVides) {
+	    coup = Coup();
+	    coup.type = TC_PASSER;
+	    return true;
+	}
+	if (rang > nbVides) {
+	    return false;
+	}
+
+	// intersection vide de ce rang dans l'ordre de Goban::id()
+	int taille = enTete_->taille;
+	for (int id = 0; id < taille * taille; ++id) {
+	    Intersection inter(id % taille, id / taille);
+	    if (etat_.etat(inter) == EI_VIDE && rang-- == 0) {
+		coup = Coup(inter);
+		return true;
+	    }
+	}
+	return false;
+    }
+
+    EcrivainArchive::EcrivainArchive()
+	: donnees_(NULL),
+	  index_(NULL),
+	  ok_(false),
+	  nbParties_(0),
+	  position_(0),
+	  gobans_(),
+	  etat_(),
+	  positions_(),
+	  tampon_(),
+	  bits_(0),
+	  nbBits_(0)
+    {
+    }
+
+    EcrivainArchive::~EcrivainArchive()
+    {
+	fermer();
+    }
+
+    bool
+    EcrivainArchive::ouvrir(const std::string& fichier)
+    {
+	fermer();
+
+	donnees_ = std::fopen(fichier.c_str(), "wb");
+	index_ = std::fopen(Archive::nomIndex(fichier).c_str(), "wb");
+	ok_ = donnees_ != NULL && index_ != NULL;
+	nbParties_ = 0;
+	position_ = sizeof(Archive::MAGIE);
+
+	// le nombre de parties est complété à la fermeture
+	Archive::EnTeteIndex enTete;
+	std::memcpy(enTete.magie, Archive::MAGIE_INDEX,
+		    sizeof(Archive::MAGIE_INDEX));
+	enTete.nbParties = 0;
+	ok_ = ok_ &&
+	    std::fwrite(Archive::MAGIE, sizeof(Archive::MAGIE), 1, donnees_) == 1 &&
+	    std::fwrite(&enTete, sizeof(enTete), 1, index_) == 1;
+	if (!ok_) {
+	    fermer();
+	}
+	return ok_;
+    }
+
+    bool
+    EcrivainArchive::ajouter(const PartieSgf& partie)
+    {
+	if (donnees_ == NULL || !ok_ ||
+	    partie.taille < 2 || partie.taille > Bitboard::TAILLE_MAX ||
+	    !partie.blanches.empty() || partie.noires.size() > 0xff ||
+	    partie.coups.size() > 0xffff ||
+	    partie.komi < -8000 || partie.komi > 8000) {
+	    return false;
+	}
+
+	// la partie est codée entièrement avant d'être écrite, pour
+	// qu'une partie refusée ne laisse pas de trace
+	etat_ = EtatGoban(gobans_.goban(partie.taille, 0));
+	tampon_.clear();
+	bits_ = 0;
+	nbBits_ = 0;
+	for (unsigned int n = 0; n < partie.noires.size(); ++n) {
+	    Coup coup(partie.noires[n]);
+	    if (!coder(coup) || !etat_.poser(coup.intersection, true)) {
+		return false;
+	    }
+	}
+	// les règles sont celles de jeu::Partie, afin que toute partie
+	// de l'archive puisse y être rejouée : ko et superko
+	// positionnel, et fin de la partie après deux passes
+	positions_.clear();
+	positions_.insert(etat_.hash());
+	bool noir = partie.premierNoir;
+	bool passe = false;
+	for (unsigned int n = 0; n < partie.coups.size(); ++n) {
+	    const Coup& coup = partie.coups[n];
+	    if (!coder(coup)) {
+		return false;
+	    }
+	    if (coup.type == TC_POSER) {
+		if (etat_.ko(coup.intersection) ||
+		    !etat_.poser(coup.intersection, noir) ||
+		    !positions_.insert(etat_.hash()).second) {
+		    return false;
+		}
+		passe = false;
+	    }
+	    else {
+		if (passe && n + 1 < partie.coups.size()) {
+		    return false;
+		}
+		etat_.passer();
+		passe = true;
+	    }
+	    noir = !noir;
+	}
+	if (nbBits_ > 0) {
+	    tampon_.push_back(bits_);
+	}
+	// les en-têtes restent alignés sur deux octets
+	if (tampon_.size() % 2 != 0) {
+	    tampon_.push_back(0);
+	}
+
+	Archive::EnTetePartie enTete;
+	enTete.nbCoups = partie.coups.size();
+	enTete.taille = partie.taille;
+	enTete.handicap = partie.noires.size();
+	enTete.komi = (int) std::floor(2 * partie.komi + 0.5);
+	enTete.premierNoir = partie.premierNoir;
+	enTete.reserve = 0;
+	Archive::coderResultat(partie.resultat, enTete);
+
+	ok_ = std::fwrite(&enTete, sizeof(enTete), 1, donnees_) == 1 &&
+	    (tampon_.empty() ||
+	     std::fwrite(&tampon_[0], 1, tampon_.size(), donnees_)
+	     == tampon_.size()) &&
+	    std::fwrite(&position_, sizeof(position_), 1, index_) == 1;
+	position_ += sizeof(enTete) + tampon_.size();
+	++nbParties_;
+	return ok_;
+    }
+
+    bool
+    EcrivainArchive::fermer()
+    {
+	if (donnees_ == NULL && index_ == NULL) {
+	    return ok_;
+	}
+
+	if (ok_) {
+	    Archive::EnTeteIndex enTete;
+	    std::memcpy(enTete.magie, Archive::MAGIE_INDEX,
+			sizeof(Archive::MAGIE_INDEX));
+	    enTete.nbParties = nbParties_;
+	    ok_ = std::fwrite(&position_, sizeof(position_), 1, index_) == 1 &&
+		std::fseek(index_, 0, SEEK_SET) == 0 &&
+		std::fwrite(&enTete, sizeof(enTete), 1, index_) == 1;
+	}
+	if (donnees_ != NULL && std::fclose(donnees_) != 0) {
+	    ok_ = false;
+	}
+	if (index_ != NULL && std::fclose(index_) != 0) {
+	    ok_ = false;
+	}
+	donnees_ = NULL;
+	index_ = NULL;
+	return ok_;
+    }
+
+    bool
+    EcrivainArchive::coder(const Coup& coup)
+    {
+	int nbVides = etat_.nbVides();
+	int rang = nbVides;
+	if (coup.type == TC_POSER) {
+	    int taille = etat_.goban().taille();
+	    const Intersection& inter = coup.intersection;
+	    if (inter.i < 0 || inter.i >= taille ||
+		inter.j < 0 || inter.j >= taille ||
+		etat_.etat(inter) != EI_VIDE) {
+		return false;
+	    }
+	    // rang parmi les intersections vides dans l'ordre de
+	    // Goban::id()
+	    rang = 0;
+	    int id = etat_.goban().id(inter);
+	    for (int autre = 0; autre < id; ++autre) {
+		if (etat_.etat(Intersection(autre % taille, autre / taille))
+		    == EI_VIDE) {
+		    ++rang;
+		}
+	    }
+	}
+	else if (coup.type != TC_PASSER) {
+	    return false;
+	}
+
+	bits_ |= (uint64_t) rang << nbBits_;
+	nbBits_ += Archive::largeur(nbVides);
+	while (nbBits_ >= 8) {
+	    tampon_.push_back(bits_);
+	    bits_ >>= 8;
+	    nbBits_ -= 8;
+	}
+	return true;
+    }
+
+}
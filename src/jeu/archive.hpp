@@ -0,0 +1,521 @@
+#ifndef JEU_ARCHIVE_HPP
+#define JEU_ARCHIVE_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdio> // std::FILE
+#include <stdint.h> // uint64_t, uint16_t, int16_t, uint8_t
+#include <string> // std::string
+#include <unordered_set> // std::unordered_set
+#include <vector> // std::vector
+
+#include <jeu/types.hpp> // jeu::Coup
+#include <jeu/goban.hpp> // jeu::Gobans
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/sgf.hpp> // jeu::PartieSgf
+
+namespace jeu {
+
+    /**
+     * \brief Archive de parties au format binaire compact,
+     *        projetée en mémoire.
+     *
+     * Le fichier de données commence par une signature, suivie des
+     * parties les unes après les autres. Chaque partie est un
+     * en-tête de taille fixe suivi de ses coups, codés sur un
+     * nombre de bits variable et complétés jusqu'à un nombre pair
+     * d'octets, afin que les en-têtes restent alignés.
+     *
+     * Un coup est codé par son rang parmi les intersections vides,
+     * dans l'ordre de jeu::Goban::id(), le rang égal au nombre
+     * d'intersections vides désignant un passe ; il occupe juste
+     * assez de bits pour ce nombre. Sur un goban de 19, un coup
+     * prend 9 bits tant qu'il reste plus de 255 intersections
+     * vides, puis 8 bits ou moins. Les pierres de handicap sont
+     * codées de même en tête de partie.
+     *
+     * Le fichier d'index, de même nom suivi de .index, donne la
+     * position de chaque partie dans le fichier de données, si bien
+     * que l'accès à la n-ième partie est immédiat. Les deux
+     * fichiers sont projetés en mémoire à l'ouverture, sans lecture
+     * ni analyse.
+     *
+     * Les entiers sont stockés dans l'ordre des octets de la
+     * machine qui a construit les fichiers.
+     *
+     * @see Relecture, EcrivainArchive
+     */
+    class Archive {
+
+    public:
+
+	/**
+	 * \brief Vainqueur d'une partie.
+	 */
+	enum Vainqueur {V_INCONNU, V_NOIR, V_BLANC, V_EGALITE};
+
+	/**
+	 * \brief Manière dont une partie s'est terminée.
+	 */
+	enum Fin {F_INCONNUE, F_POINTS, F_ABANDON, F_TEMPS};
+
+	/**
+	 * \brief En-tête d'une partie.
+	 */
+	struct EnTetePartie {
+
+	    /**
+	     * \brief Nombre de coups après les pierres de handicap,
+	     *        passes comprises.
+	     */
+	    uint16_t nbCoups;
+
+	    uint8_t taille;
+
+	    /**
+	     * \brief Nombre de pierres noires placées avant le premier
+	     *        coup.
+	     */
+	    uint8_t handicap;
+
+	    /**
+	     * \brief Komi en demi-points.
+	     */
+	    int16_t komi;
+
+	    /**
+	     * \brief Écart final en demi-points pour une partie
+	     *        terminée aux points, positif si noir a gagné.
+	     */
+	    int16_t ecart;
+
+	    /**
+	     * \brief Vainqueur, de type Vainqueur.
+	     */
+	    uint8_t vainqueur;
+
+	    /**
+	     * \brief Fin de la partie, de type Fin.
+	     */
+	    uint8_t fin;
+
+	    /**
+	     * \brief Savoir si noir joue le premier coup.
+	     */
+	    uint8_t premierNoir;
+
+	    uint8_t reserve;
+
+	};
+
+	/**
+	 * \brief En-tête du fichier d'index, suivi des positions des
+	 *        parties et de la fin du fichier de données.
+	 */
+	struct EnTeteIndex {
+
+	    /**
+	     * \brief Signature du format, égale à MAGIE_INDEX.
+	     */
+	    char magie[8];
+
+	    uint64_t nbParties;
+
+	};
+
+	/**
+	 * \brief Signature des fichiers de données.
+	 */
+	static const char MAGIE[8];
+
+	/**
+	 * \brief Signature des fichiers d'index.
+	 */
+	static const char MAGIE_INDEX[8];
+
+	/**
+	 * \brief Constructeur d'archive vide.
+	 */
+	Archive();
+
+	/**
+	 * \brief Destructeur, qui libère les projections.
+	 */
+	~Archive();
+
+	/**
+	 * \brief Projection en mémoire d'un fichier de données et de
+	 *        son index.
+	 *
+	 * La valeur de retour indique si les fichiers ont pu être
+	 * ouverts et s'ils sont cohérents. En cas d'échec l'archive
+	 * est vide.
+	 */
+	bool
+	ouvrir(const std::string& fichier);
+
+	/**
+	 * \brief Libération des projections.
+	 */
+	void
+	fermer();
+
+	/**
+	 * \brief Savoir si une archive est projetée.
+	 */
+	inline
+	bool
+	ouverte() const
+	{
+	    return index_ != NULL;
+	}
+
+	inline
+	long
+	nbParties() const
+	{
+	    return index_ ? index_->nbParties : 0;
+	}
+
+	/**
+	 * \brief Accès à l'en-tête d'une partie.
+	 */
+	inline
+	const EnTetePartie&
+	enTete(long n) const
+	{
+	    return *reinterpret_cast<const EnTetePartie*>(
+		donnees_ + positions_[n]);
+	}
+
+	/**
+	 * \brief Accès aux coups codés d'une partie.
+	 *
+	 * Le second paramètre reçoit l'adresse de la fin des coups.
+	 */
+	inline
+	const uint8_t*
+	coups(long n, const uint8_t*& fin) const
+	{
+	    fin = donnees_ + positions_[n + 1];
+	    return donnees_ + positions_[n] + sizeof(EnTetePartie);
+	}
+
+	/**
+	 * \brief Codage d'un résultat noté comme dans un fichier SGF.
+	 */
+	static
+	void
+	coderResultat(const std::string& resultat, EnTetePartie& enTete);
+
+	/**
+	 * \brief Résultat d'une partie noté comme dans un fichier SGF,
+	 *        vide s'il est inconnu.
+	 */
+	static
+	std::string
+	resultat(const EnTetePartie& enTete);
+
+	/**
+	 * \brief Nom du fichier d'index d'un fichier de données.
+	 */
+	static
+	std::string
+	nomIndex(const std::string& fichier);
+
+	/**
+	 * \brief Nombre de bits d'un coup codé quand il reste un
+	 *        nombre donné d'intersections vides.
+	 */
+	static inline
+	int
+	largeur(int nbVides)
+	{
+	    int largeur = 0;
+	    while ((1 << largeur) <= nbVides) {
+		++largeur;
+	    }
+	    return largeur;
+	}
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	Archive(const Archive&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	Archive&
+	operator=(const Archive&);
+
+	/**
+	 * \brief Projections des fichiers de données et d'index,
+	 *        NULL si aucun fichier n'est projeté.
+	 */
+	void* projection_;
+	void* projectionIndex_;
+
+	std::size_t longueur_;
+	std::size_t longueurIndex_;
+
+	const uint8_t* donnees_;
+
+	const EnTeteIndex* index_;
+
+	/**
+	 * \brief Positions des parties dans le fichier de données,
+	 *        suivies de sa longueur.
+	 */
+	const uint64_t* positions_;
+
+    };
+
+    /**
+     * \brief Relecture des parties d'une archive, coup par coup.
+     *
+     * Après commencer(), l'état et le trait sont ceux du départ de
+     * la partie, pierres de handicap posées : c'est de là qu'une
+     * jeu::Partie peut être construite, avant de lui faire jouer
+     * les coups rendus par suivant(). L'état de la relecture avance
+     * avec les coups.
+     *
+     * Une relecture n'est utilisée que par un thread à la fois ;
+     * plusieurs relectures peuvent parcourir la même archive en
+     * parallèle.
+     */
+    class Relecture {
+
+    public:
+
+	/**
+	 * \brief Constructeur de relecture d'une archive ouverte.
+	 */
+	explicit
+	Relecture(const Archive& archive);
+
+	/**
+	 * \brief Début de la relecture d'une partie.
+	 *
+	 * La valeur de retour indique si la partie existe et si ses
+	 * pierres de handicap ont pu être posées.
+	 */
+	bool
+	commencer(long n);
+
+	/**
+	 * \brief Décodage du coup suivant, qui est joué sur l'état de
+	 *        la relecture.
+	 *
+	 * La valeur de retour est fausse à la fin de la partie, ou si
+	 * le coup est invalide ou illicite.
+	 */
+	bool
+	suivant(Coup& coup);
+
+	/**
+	 * \brief Relecture d'une partie entière dans une partie
+	 *        lue d'un fichier SGF.
+	 */
+	bool
+	lire(long n, PartieSgf& partie);
+
+	/**
+	 * \brief Accès à l'en-tête de la partie en cours.
+	 */
+	inline
+	const Archive::EnTetePartie&
+	enTete() const
+	{
+	    return *enTete_;
+	}
+
+	/**
+	 * \brief Accès à l'état du goban de la partie en cours.
+	 */
+	inline
+	const EtatGoban&
+	etat() const
+	{
+	    return etat_;
+	}
+
+	/**
+	 * \brief Savoir si c'est à noir de jouer le prochain coup.
+	 */
+	inline
+	bool
+	tourNoir() const
+	{
+	    return tourNoir_;
+	}
+
+	/**
+	 * \brief Nombre de coups déjà décodés, pierres de handicap
+	 *        non comprises.
+	 */
+	inline
+	int
+	nbCoups() const
+	{
+	    return nbCoups_;
+	}
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	Relecture(const Relecture&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	Relecture&
+	operator=(const Relecture&);
+
+	/**
+	 * \brief Décodage d'une intersection vide ou d'un passe.
+	 */
+	bool
+	decoder(Coup& coup);
+
+	const Archive& archive_;
+
+	/**
+	 * \brief Gobans des parties relues, gardés pour les
+	 *        suivantes.
+	 */
+	Gobans gobans_;
+
+	const Archive::EnTetePartie* enTete_;
+
+	EtatGoban etat_;
+
+	bool tourNoir_;
+
+	int nbCoups_;
+
+	/**
+	 * \brief Prochain octet à lire et fin des coups.
+	 */
+	const uint8_t* octet_;
+	const uint8_t* fin_;
+
+	/**
+	 * \brief Bits lus mais pas encore décodés, les premiers dans
+	 *        les bits de poids faible.
+	 */
+	uint64_t bits_;
+	int nbBits_;
+
+    };
+
+    /**
+     * \brief Écriture d'une archive de parties.
+     *
+     * Les parties sont ajoutées une à une aux fichiers de données
+     * et d'index, dont l'en-tête n'est complété qu'à la fermeture.
+     */
+    class EcrivainArchive {
+
+    public:
+
+	EcrivainArchive();
+
+	/**
+	 * \brief Destructeur, qui ferme les fichiers.
+	 */
+	~EcrivainArchive();
+
+	/**
+	 * \brief Création d'un fichier de données et de son index.
+	 */
+	bool
+	ouvrir(const std::string& fichier);
+
+	/**
+	 * \brief Ajout d'une partie.
+	 *
+	 * La valeur de retour indique si la partie a été ajoutée :
+	 * elle ne l'est pas si l'un de ses coups est refusé par
+	 * jeu::Partie, ko et superko compris, ou suit deux passes, si
+	 * elle a des pierres blanches de départ ou si elle dépasse
+	 * les limites du format.
+	 */
+	bool
+	ajouter(const PartieSgf& partie);
+
+	/**
+	 * \brief Fermeture des fichiers, après écriture de la fin de
+	 *        l'index.
+	 *
+	 * La valeur de retour indique si toutes les écritures ont
+	 * réussi.
+	 */
+	bool
+	fermer();
+
+	inline
+	long
+	nbParties() const
+	{
+	    return nbParties_;
+	}
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	EcrivainArchive(const EcrivainArchive&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	EcrivainArchive&
+	operator=(const EcrivainArchive&);
+
+	/**
+	 * \brief Codage d'un coup joué sur l'état en cours.
+	 */
+	bool
+	coder(const Coup& coup);
+
+	std::FILE* donnees_;
+	std::FILE* index_;
+
+	bool ok_;
+
+	long nbParties_;
+
+	/**
+	 * \brief Position de la prochaine partie dans le fichier de
+	 *        données.
+	 */
+	uint64_t position_;
+
+	Gobans gobans_;
+
+	EtatGoban etat_;
+
+	/**
+	 * \brief Hachages des positions de la partie en cours, pour
+	 *        le superko.
+	 */
+	std::unordered_set<uint64_t> positions_;
+
+	/**
+	 * \brief Coups codés de la partie en cours.
+	 */
+	std::vector<uint8_t> tampon_;
+
+	uint64_t bits_;
+	int nbBits_;
+
+    };
+
+}
+
+#endif
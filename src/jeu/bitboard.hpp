@@ -0,0 +1,326 @@
+#ifndef JEU_BITBOARD_HPP
+#define JEU_BITBOARD_HPP
+
+#include <stdint.h> // uint64_t
+
+#ifdef __SSE2__
+#include <emmintrin.h> // _mm_*
+#endif
+#ifdef __AVX2__
+#include <immintrin.h> // _mm256_*
+#endif
+
+namespace jeu {
+
+    /**
+     * \brief Ensemble d'intersections représenté par un tableau de
+     *        bits.
+     *
+     * Les bits sont indexés comme les tableaux internes de
+     * EtatGoban, c'est-à-dire avec une bordure d'une intersection
+     * autour du goban : l'intersection (i, j) correspond au bit
+     * (i + 1) + (taille + 2) * (j + 1). Grâce à cette bordure, un
+     * décalage d'un bit ou d'une ligne ne fait jamais passer une
+     * intersection du goban d'un côté à l'autre.
+     *
+     * La taille du tableau est fixe, ce qui permet de copier et de
+     * combiner les ensembles sans allocation. Elle suffit pour des
+     * gobans jusqu'à TAILLE_MAX intersections de côté.
+     */
+    class Bitboard {
+
+    public:
+
+	/**
+	 * \brief Taille maximale des gobans représentables.
+	 */
+	static const int TAILLE_MAX = 25;
+
+	/**
+	 * \brief Nombre de mots de 64 bits du tableau.
+	 */
+	static const int NB_MOTS =
+	    ((TAILLE_MAX + 2) * (TAILLE_MAX + 2) + 63) / 64;
+
+	/**
+	 * \brief Constructeur d'ensemble vide.
+	 */
+	Bitboard()
+	{
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		mots_[m] = 0;
+	    }
+	}
+
+	/**
+	 * \brief Appartenance d'une intersection à l'ensemble.
+	 */
+	inline
+	bool
+	contient(int k) const
+	{
+	    return (mots_[k >> 6] >> (k & 63)) & 1;
+	}
+
+	/**
+	 * \brief Ajout d'une intersection à l'ensemble.
+	 */
+	inline
+	void
+	ajouter(int k)
+	{
+	    mots_[k >> 6] |= (uint64_t) 1 << (k & 63);
+	}
+
+	/**
+	 * \brief Retrait d'une intersection de l'ensemble.
+	 */
+	inline
+	void
+	retirer(int k)
+	{
+	    mots_[k >> 6] &= ~((uint64_t) 1 << (k & 63));
+	}
+
+	/**
+	 * \brief Savoir si l'ensemble est vide.
+	 */
+	inline
+	bool
+	vide() const
+	{
+	    uint64_t ou = 0;
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		ou |= mots_[m];
+	    }
+	    return ou == 0;
+	}
+
+	/**
+	 * \brief Nombre d'intersections de l'ensemble.
+	 */
+	inline
+	int
+	nbBits() const
+	{
+	    int n = 0;
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		n += __builtin_popcountll(mots_[m]);
+	    }
+	    return n;
+	}
+
+	/**
+	 * \brief Plus petite intersection de l'ensemble.
+	 *
+	 * L'ensemble ne doit pas être vide.
+	 */
+	inline
+	int
+	premier() const
+	{
+	    int m = 0;
+	    while (mots_[m] == 0) {
+		++m;
+	    }
+	    return (m << 6) + __builtin_ctzll(mots_[m]);
+	}
+
+	/**
+	 * \brief Union avec un autre ensemble.
+	 */
+	inline
+	Bitboard&
+	operator|=(const Bitboard& b)
+	{
+#if defined(__AVX2__)
+	    for (int m = 0; m + 4 <= NB_MOTS; m += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (mots_ + m));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b.mots_ + m));
+		_mm256_storeu_si256((__m256i*) (mots_ + m), _mm256_or_si256(x, y));
+	    }
+	    for (int m = NB_MOTS & ~3; m < NB_MOTS; ++m) {
+		mots_[m] |= b.mots_[m];
+	    }
+#elif defined(__SSE2__)
+	    for (int m = 0; m + 2 <= NB_MOTS; m += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (mots_ + m));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b.mots_ + m));
+		_mm_storeu_si128((__m128i*) (mots_ + m), _mm_or_si128(x, y));
+	    }
+	    for (int m = NB_MOTS & ~1; m < NB_MOTS; ++m) {
+		mots_[m] |= b.mots_[m];
+	    }
+#else
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		mots_[m] |= b.mots_[m];
+	    }
+#endif
+	    return *this;
+	}
+
+	/**
+	 * \brief Intersection avec un autre ensemble.
+	 */
+	inline
+	Bitboard&
+	operator&=(const Bitboard& b)
+	{
+#if defined(__AVX2__)
+	    for (int m = 0; m + 4 <= NB_MOTS; m += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (mots_ + m));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b.mots_ + m));
+		_mm256_storeu_si256((__m256i*) (mots_ + m), _mm256_and_si256(x, y));
+	    }
+	    for (int m = NB_MOTS & ~3; m < NB_MOTS; ++m) {
+		mots_[m] &= b.mots_[m];
+	    }
+#elif defined(__SSE2__)
+	    for (int m = 0; m + 2 <= NB_MOTS; m += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (mots_ + m));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b.mots_ + m));
+		_mm_storeu_si128((__m128i*) (mots_ + m), _mm_and_si128(x, y));
+	    }
+	    for (int m = NB_MOTS & ~1; m < NB_MOTS; ++m) {
+		mots_[m] &= b.mots_[m];
+	    }
+#else
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		mots_[m] &= b.mots_[m];
+	    }
+#endif
+	    return *this;
+	}
+
+	/**
+	 * \brief Retrait des intersections d'un autre ensemble.
+	 */
+	inline
+	Bitboard&
+	sauf(const Bitboard& b)
+	{
+#if defined(__AVX2__)
+	    for (int m = 0; m + 4 <= NB_MOTS; m += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (mots_ + m));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b.mots_ + m));
+		_mm256_storeu_si256((__m256i*) (mots_ + m), _mm256_andnot_si256(y, x));
+	    }
+	    for (int m = NB_MOTS & ~3; m < NB_MOTS; ++m) {
+		mots_[m] &= ~b.mots_[m];
+	    }
+#elif defined(__SSE2__)
+	    for (int m = 0; m + 2 <= NB_MOTS; m += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (mots_ + m));
+		__m128i y = _mm_loadu_si128((const __m128i*) (b.mots_ + m));
+		_mm_storeu_si128((__m128i*) (mots_ + m), _mm_andnot_si128(y, x));
+	    }
+	    for (int m = NB_MOTS & ~1; m < NB_MOTS; ++m) {
+		mots_[m] &= ~b.mots_[m];
+	    }
+#else
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		mots_[m] &= ~b.mots_[m];
+	    }
+#endif
+	    return *this;
+	}
+
+	/**
+	 * \brief Ensemble augmenté de tous les voisins de ses
+	 *        intersections.
+	 *
+	 * Le paramètre est la largeur d'une ligne, bordure comprise,
+	 * c'est-à-dire la taille du goban plus deux. Le résultat peut
+	 * contenir des intersections de la bordure.
+	 */
+	inline
+	Bitboard
+	dilatation(int largeur) const
+	{
+	    Bitboard resultat;
+	    uint64_t precedent = 0;
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		uint64_t suivant = m + 1 < NB_MOTS ? mots_[m + 1] : 0;
+		resultat.mots_[m] = mots_[m]
+		    | (mots_[m] << 1) | (precedent >> 63)
+		    | (mots_[m] >> 1) | (suivant << 63)
+		    | (mots_[m] << largeur) | (precedent >> (64 - largeur))
+		    | (mots_[m] >> largeur) | (suivant << (64 - largeur));
+		precedent = mots_[m];
+	    }
+	    return resultat;
+	}
+
+	/**
+	 * \brief Composante connexe d'une intersection à l'intérieur
+	 *        de l'ensemble.
+	 *
+	 * La composante est obtenue par dilatations successives
+	 * restreintes à l'ensemble, sans parcours intersection par
+	 * intersection.
+	 */
+	inline
+	Bitboard
+	composante(int k, int largeur) const
+	{
+	    Bitboard zone;
+	    zone.ajouter(k);
+	    int taille = 1;
+	    for (;;) {
+		Bitboard suivante(zone.dilatation(largeur));
+		suivante &= *this;
+		int tailleSuivante = suivante.nbBits();
+		if (tailleSuivante == taille) {
+		    return zone;
+		}
+		zone = suivante;
+		taille = tailleSuivante;
+	    }
+	}
+
+	/**
+	 * \brief Opérateur d'égalité d'ensembles.
+	 */
+	inline
+	bool
+	operator==(const Bitboard& b) const
+	{
+	    uint64_t difference = 0;
+	    for (int m = 0; m < NB_MOTS; ++m) {
+		difference |= mots_[m] ^ b.mots_[m];
+	    }
+	    return difference == 0;
+	}
+
+    private:
+
+	/**
+	 * \brief Mots du tableau de bits.
+	 */
+	uint64_t mots_[NB_MOTS];
+
+    };
+
+    /**
+     * \brief Union de deux ensembles.
+     */
+    inline
+    Bitboard
+    operator|(Bitboard b1, const Bitboard& b2)
+    {
+	return b1 |= b2;
+    }
+
+    /**
+     * \brief Intersection de deux ensembles.
+     */
+    inline
+    Bitboard
+    operator&(Bitboard b1, const Bitboard& b2)
+    {
+	return b1 &= b2;
+    }
+
+}
+
+#endif
@@ -0,0 +1,39 @@
+#include <jeu/goban.hpp> // jeu::Goban
+
+#include <jeu/espacetravail.hpp> // jeu::EspaceTravail
+
+namespace jeu {
+
+    EspaceTravail::EspaceTravail()
+	: pile_(),
+	  pierres_()
+    {
+    }
+
+    EspaceTravail::EspaceTravail(const Goban& goban)
+	: pile_(),
+	  pierres_()
+    {
+	dimensionner(goban);
+    }
+
+    void
+    EspaceTravail::dimensionner(const Goban& goban)
+    {
+	// une chaîne ou une liste de pierres ne peut pas dépasser le
+	// nombre d'intersections, bordure comprise
+	std::vector<int>::size_type taille =
+	    (goban.taille() + 2) * (goban.taille() + 2);
+	pile_.reserve(taille);
+	pierres_.reserve(taille);
+    }
+
+    EspaceTravail&
+    EspaceTravail::local(const Goban& goban)
+    {
+	static thread_local EspaceTravail espace;
+	espace.dimensionner(goban);
+	return espace;
+    }
+
+}
@@ -0,0 +1,91 @@
+#ifndef JEU_ESPACETRAVAIL_HPP
+#define JEU_ESPACETRAVAIL_HPP
+
+#include <vector> // std::vector
+
+#include <jeu/goban.hpp> // jeu::Goban
+
+namespace jeu {
+
+    /**
+     * \brief Classe regroupant les tableaux de travail des parcours
+     *        du goban.
+     *
+     * Les parcours de chaînes ont besoin d'une pile et d'une liste
+     * de pierres. Plutôt que d'allouer ces tableaux à chaque appel,
+     * ou de les partager dans des variables statiques, ils sont
+     * regroupés dans un espace de travail dimensionné pour un
+     * goban. Un espace ne doit être utilisé que par un thread à la
+     * fois : chaque thread dispose du sien grâce à local(), et un
+     * appelant peut aussi fournir le sien explicitement.
+     */
+    class EspaceTravail {
+
+    public:
+
+	/**
+	 * \brief Constructeur d'espace vide.
+	 *
+	 * L'espace devra être dimensionné avant usage.
+	 *
+	 * @see dimensionner(const Goban&)
+	 */
+	EspaceTravail();
+
+	/**
+	 * \brief Constructeur d'espace dimensionné pour un goban.
+	 */
+	explicit
+	EspaceTravail(const Goban& goban);
+
+	/**
+	 * \brief Dimensionnement de l'espace pour un goban.
+	 *
+	 * Les tableaux sont agrandis si nécessaire, jamais réduits :
+	 * un même espace peut donc servir successivement pour des
+	 * gobans de tailles différentes.
+	 */
+	void
+	dimensionner(const Goban& goban);
+
+	/**
+	 * \brief Espace de travail propre au thread appelant,
+	 *        dimensionné pour le goban passé en paramètre.
+	 */
+	static
+	EspaceTravail&
+	local(const Goban& goban);
+
+	/**
+	 * \brief Pile d'indices d'intersections, vide entre deux
+	 *        utilisations.
+	 */
+	inline
+	std::vector<int>&
+	pile()
+	{
+	    return pile_;
+	}
+
+	/**
+	 * \brief Liste d'indices de pierres, vide entre deux
+	 *        utilisations.
+	 */
+	inline
+	std::vector<int>&
+	pierres()
+	{
+	    return pierres_;
+	}
+
+    private:
+
+	std::vector<int> pile_;
+
+	std::vector<int> pierres_;
+
+    };
+
+}
+
+#endif
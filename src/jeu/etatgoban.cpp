@@ -1,8 +1,9 @@
 #include <iostream>
-#include <stack> // std::stack
+#include <algorithm> // std::swap, std::fill, std::copy
 
 #include <jeu/types.hpp>
 #include <jeu/goban.hpp>
+#include <jeu/symetrie.hpp>
 
 #include <jeu/etatgoban.hpp>
 
@@ -10,16 +11,39 @@ namespace jeu {
 
     EtatGoban::EtatGoban()
 	: goban_(NULL),
+	  largeur_(0),
 	  etats_(0, EI_VIDE),
+	  representants_(),
+	  suivantes_(),
+	  chaines_(),
+	  vides_(),
+	  positionsVides_(),
+	  motifs_(),
+	  pierres_(),
+	  ko_(-1),
 	  score_()
     {
+	initialiserGeometrie();
+	std::fill(hashs_, hashs_ + Symetrie::NB, 0);
     }
 
     EtatGoban::EtatGoban(const Goban& goban)
 	: goban_(&goban),
+	  largeur_(goban.taille() + 2),
 	  etats_((goban.taille() + 2) * (goban.taille() + 2), EI_VIDE),
-	  score_(0, goban.komi())
+	  representants_(etats_.size(), 0),
+	  suivantes_(etats_.size(), 0),
+	  chaines_(etats_.size()),
+	  vides_(),
+	  positionsVides_(etats_.size(), -1),
+	  motifs_(etats_.size(), 0),
+	  pierres_(),
+	  ko_(-1),
+	  score_(0, goban.demiKomi())
     {
+	initialiserGeometrie();
+	std::fill(hashs_, hashs_ + Symetrie::NB, 0);
+
 	// initialement tout est vide sauf les bords qui sont gris
 	for (int i = -1; i <= goban.taille(); ++i) {
 	    etat(Intersection(i, -1))
@@ -28,135 +52,439 @@ namespace jeu {
 		= etat(Intersection(goban.taille(), i))
 		= EI_GRIS;
 	}
+
+	vides_.reserve(goban.taille() * goban.taille());
+	Intersection inter;
+	for (inter.j = 0; inter.j < goban.taille(); ++inter.j) {
+	    for (inter.i = 0; inter.i < goban.taille(); ++inter.i) {
+		ajouterVide(indice(inter));
+	    }
+	}
+
+	initialiserMotifs();
     }
 
     EtatGoban::EtatGoban(const EtatGoban& etatGoban)
 	: goban_(etatGoban.goban_),
+	  largeur_(etatGoban.largeur_),
 	  etats_(etatGoban.etats_),
+	  representants_(etatGoban.representants_),
+	  suivantes_(etatGoban.suivantes_),
+	  chaines_(etatGoban.chaines_),
+	  vides_(etatGoban.vides_),
+	  positionsVides_(etatGoban.positionsVides_),
+	  motifs_(etatGoban.motifs_),
+	  pierres_(),
+	  ko_(etatGoban.ko_),
 	  score_(etatGoban.score_)
     {
+	initialiserGeometrie();
+	pierres_[EI_NOIR] = etatGoban.pierres_[EI_NOIR];
+	pierres_[EI_BLANC] = etatGoban.pierres_[EI_BLANC];
+	std::copy(etatGoban.hashs_, etatGoban.hashs_ + Symetrie::NB, hashs_);
     }
 
     EtatGoban&
     EtatGoban::operator=(const EtatGoban& etatGoban)
     {
 	goban_ = etatGoban.goban_;
+	largeur_ = etatGoban.largeur_;
+	initialiserGeometrie();
 	etats_ = etatGoban.etats_; // recopie le vecteur
+	representants_ = etatGoban.representants_;
+	suivantes_ = etatGoban.suivantes_;
+	chaines_ = etatGoban.chaines_;
+	vides_ = etatGoban.vides_;
+	positionsVides_ = etatGoban.positionsVides_;
+	motifs_ = etatGoban.motifs_;
+	pierres_[EI_NOIR] = etatGoban.pierres_[EI_NOIR];
+	pierres_[EI_BLANC] = etatGoban.pierres_[EI_BLANC];
+	std::copy(etatGoban.hashs_, etatGoban.hashs_ + Symetrie::NB, hashs_);
+	ko_ = etatGoban.ko_;
 	score_ = etatGoban.score_;
 	return *this;
     }
 
+    void
+    EtatGoban::initialiserGeometrie()
+    {
+	decalages_[D_HAUT] = -1;
+	decalages_[D_BAS] = 1;
+	decalages_[D_GAUCHE] = -largeur_;
+	decalages_[D_DROITE] = largeur_;
+
+	// ordre de lecture du carré 3x3, centre exclu
+	int v = 0;
+	for (int di = -1; di <= 1; ++di) {
+	    for (int dj = -1; dj <= 1; ++dj) {
+		if (di != 0 || dj != 0) {
+		    decalagesMotif_[v++] = di + largeur_ * dj;
+		}
+	    }
+	}
+    }
+
+    void
+    EtatGoban::initialiserMotifs()
+    {
+	Intersection inter;
+	for (inter.j = 0; inter.j < goban().taille(); ++inter.j) {
+	    for (inter.i = 0; inter.i < goban().taille(); ++inter.i) {
+		int k = indice(inter);
+		uint16_t m = 0;
+		for (int v = 0; v < NB_VOISINS_MOTIF; ++v) {
+		    m |= etats_[k + decalagesMotif_[v]] << (2 * v);
+		}
+		motifs_[k] = m;
+	    }
+	}
+    }
+
     bool
     EtatGoban::poser(const Intersection& inter, bool pierreNoire)
+    {
+	return poser(indice(inter), pierreNoire, NULL);
+    }
+
+    bool
+    EtatGoban::poser(const Intersection& inter, bool pierreNoire,
+		     Mouvement& mouvement, std::vector<int>& prises)
+    {
+	Score avant(score_);
+	int ko = ko_;
+	int hauteur = prises.size();
+
+	if (!poser(indice(inter), pierreNoire, &prises)) {
+	    return false;
+	}
+
+	mouvement.intersection = inter;
+	mouvement.noir = pierreNoire;
+	mouvement.ko = ko;
+	mouvement.nbPrises = prises.size() - hauteur;
+	mouvement.deltaScore = Score(score_.noir - avant.noir,
+				     score_.blanc - avant.blanc);
+	return true;
+    }
+
+    bool
+    EtatGoban::poser(int k, bool pierreNoire, std::vector<int>* prises)
     {
 	EtatIntersection joueur = pierreNoire ? EI_NOIR : EI_BLANC;
 	EtatIntersection adversaire = pierreNoire ? EI_BLANC : EI_NOIR;
 
-
-	// est-ce que l'intersection est vide ?
-	if (etat(inter) != EI_VIDE) {
+	// est-ce que l'intersection est vide et le coup n'est pas un
+	// suicide ?
+	if (etats_[k] != EI_VIDE || suicide(k, pierreNoire)) {
 	    return false;
 	}
 
-	etat(inter) = joueur;
+	int voisins[NB_D];
+	decalages(voisins);
+	for (int d = 0; d < NB_D; ++d) {
+	    voisins[d] += k;
+	}
+
+	// la pierre forme d'abord une chaîne à elle seule
+	etats_[k] = joueur;
+	modifierMotifs(k, joueur);
+	retirerVide(k);
+	pierres_[joueur].ajouter(k);
+	modifierHashs(k, joueur);
+	representants_[k] = k;
+	suivantes_[k] = k;
+	Chaine& nouvelle = chaines_[k];
+	nouvelle.nbPierres = 1;
+	nouvelle.nbLibertes = 0;
+	nouvelle.sommeLibertes = 0;
+	nouvelle.sommeCarresLibertes = 0;
+
+	for (int d = 0; d < NB_D; ++d) {
+	    int v = voisins[d];
+	    if (etats_[v] == EI_VIDE) {
+		ajouterLiberte(k, v);
+	    }
+	    else if (etats_[v] == EI_NOIR || etats_[v] == EI_BLANC) {
+		retirerLiberte(v, k);
+	    }
+	}
+
+	// puis elle rejoint les chaînes amies voisines
+	for (int d = 0; d < NB_D; ++d) {
+	    int v = voisins[d];
+	    if (etats_[v] == joueur &&
+		representants_[v] != representants_[k]) {
+		fusionner(k, v);
+	    }
+	}
 
 	// est-ce que je tue un voisin ?
-	Intersection voisins[NB_D];
-	inter.voisins(voisins);
-	for (int k = 0; k < NB_D; ++k) {
-	    if (etat(voisins[k]) == adversaire && mort(voisins[k])) {
-		tuer(voisins[k]);
+	int nbPrises = 0;
+	int prise = -1;
+	for (int d = 0; d < NB_D; ++d) {
+	    int v = voisins[d];
+	    if (etats_[v] == adversaire && chaine(v).nbLibertes == 0) {
+		nbPrises += chaine(v).nbPierres;
+		prise = v;
+		tuer(v, prises);
 	    }
 	}
 
-	// sinon, est-ce que je me fais tuer ?
-	if (mort(inter)) {
-	    etat(inter) = EI_VIDE;
-	    return false;
+	// une pierre seule qui en capture une seule en se retrouvant
+	// en atari crée un ko
+	const Chaine& formee = chaine(k);
+	if (nbPrises == 1 && formee.nbPierres == 1 && formee.nbLibertes == 1) {
+	    ko_ = prise;
+	}
+	else {
+	    ko_ = -1;
 	}
 
 	return true;
     }
 
-    bool
-    EtatGoban::mort(const Intersection& inter) const
+    std::vector<Intersection>
+    EtatGoban::coupsLicites(bool pierreNoire) const
     {
-	static int idVisite(0);
-	static std::vector<int>
-	    visites(goban().taille() * goban().taille(),
-		    idVisite);
-
-	++idVisite;
-	if (idVisite == 0) {
-	    // réinitialisation
-	    std::fill(visites.begin(), visites.end(), idVisite);
-	    ++idVisite;
+	std::vector<Intersection> coups;
+	std::vector<int>::const_iterator it;
+	for (it = vides_.begin(); it != vides_.end(); ++it) {
+	    if (licite(*it, pierreNoire)) {
+		coups.push_back(intersection(*it));
+	    }
 	}
+	return coups;
+    }
 
-	std::stack<Intersection> aTraiter;
-	EtatIntersection defenseur = etat(inter);
-	Intersection voisins[NB_D];
+    Coup
+    EtatGoban::coupAleatoire(bool pierreNoire, Generateur& generateur,
+			     bool eviterYeux)
+    {
+	// tirage sans remise : une intersection illicite est échangée
+	// avec la dernière candidate, qui sort de la fenêtre de tirage
+	for (int n = vides_.size(); n > 0; --n) {
+	    int r = generateur.entier(n);
+	    int k = vides_[r];
+	    if (licite(k, pierreNoire) &&
+		!(eviterYeux && oeil(k, pierreNoire))) {
+		return Coup(intersection(k));
+	    }
+	    int derniere = vides_[n - 1];
+	    vides_[r] = derniere;
+	    positionsVides_[derniere] = r;
+	    vides_[n - 1] = k;
+	    positionsVides_[k] = n - 1;
+	}
 
-	visites[goban().id(inter)] = idVisite;
-	aTraiter.push(inter);
+	Coup passer;
+	passer.type = TC_PASSER;
+	return passer;
+    }
 
-	while (!aTraiter.empty()) {
-	    Intersection& interCourante = aTraiter.top();
-	    interCourante.voisins(voisins);
-	    aTraiter.pop(); //!\\ interCourante n'est plus valide à partir d'ici
+    bool
+    EtatGoban::mort(const Intersection& inter) const
+    {
+	return libertes(inter) == 0;
+    }
 
-	    for (int k = 0; k < NB_D; ++k) {
-		Intersection& voisin = voisins[k];
-		const EtatIntersection& etatVoisin = etat(voisin);
-		int& visite = visites[goban().id(voisin)];
-		if (etatVoisin == EI_VIDE) {
-		    return false;
-		}
-		else if (etatVoisin == defenseur && visite != idVisite) {
-		    visite = idVisite;
-		    aTraiter.push(voisin);
-		}
-	    }
+    void
+    EtatGoban::fusionner(int k1, int k2)
+    {
+	int r1 = representants_[k1];
+	int r2 = representants_[k2];
+	if (chaines_[r1].nbPierres < chaines_[r2].nbPierres) {
+	    std::swap(r1, r2);
 	}
 
-	return true;
+	// renumérotation de la plus petite chaîne
+	int k = r2;
+	do {
+	    representants_[k] = r1;
+	    k = suivantes_[k];
+	} while (k != r2);
+
+	// raccordement des deux listes circulaires
+	std::swap(suivantes_[r1], suivantes_[r2]);
+
+	Chaine& c1 = chaines_[r1];
+	const Chaine& c2 = chaines_[r2];
+	c1.nbPierres += c2.nbPierres;
+	c1.nbLibertes += c2.nbLibertes;
+	c1.sommeLibertes += c2.sommeLibertes;
+	c1.sommeCarresLibertes += c2.sommeCarresLibertes;
     }
 
     void
     EtatGoban::tuer(const Intersection& inter)
+    {
+	tuer(indice(inter));
+    }
+
+    void
+    EtatGoban::tuer(int premiere, std::vector<int>* prises)
     {
 	int prisonniers = 0;
 
-	std::stack<Intersection> aTraiter;
-	EtatIntersection defenseur = etat(inter);
-	Intersection voisins[NB_D];
+	EtatIntersection defenseur = etats_[premiere];
+	int voisins[NB_D];
+	decalages(voisins);
+
+	// on vide d'abord toute la chaîne...
+	int k = premiere;
+	do {
+	    etats_[k] = EI_VIDE;
+	    modifierMotifs(k, EI_VIDE);
+	    ajouterVide(k);
+	    pierres_[defenseur].retirer(k);
+	    modifierHashs(k, defenseur);
+	    ++prisonniers;
+	    if (prises != NULL) {
+		prises->push_back(k);
+	    }
+	    k = suivantes_[k];
+	} while (k != premiere);
+
+	// ... puis on rend les libertés aux chaînes voisines
+	do {
+	    for (int d = 0; d < NB_D; ++d) {
+		int v = k + voisins[d];
+		if (etats_[v] == EI_NOIR || etats_[v] == EI_BLANC) {
+		    ajouterLiberte(v, k);
+		}
+	    }
+	    k = suivantes_[k];
+	} while (k != premiere);
 
-	etat(inter) = EI_VIDE;
-	aTraiter.push(inter);
+	if (defenseur == EI_NOIR) {
+	    score().noir -= 2 * prisonniers;
+	}
+	else {
+	    score().blanc -= 2 * prisonniers;
+	}
+    }
 
-	while (!aTraiter.empty()) {
-	    Intersection& interCourante = aTraiter.top();
+    void
+    EtatGoban::annuler(const Mouvement& mouvement, std::vector<int>& prises)
+    {
+	annuler(mouvement, prises, EspaceTravail::local(goban()));
+    }
 
-	    interCourante.voisins(voisins);
-	    ++prisonniers;
+    void
+    EtatGoban::annuler(const Mouvement& mouvement, std::vector<int>& prises,
+		       EspaceTravail& espace)
+    {
+	bool noir = mouvement.noir;
+	EtatIntersection joueur = noir ? EI_NOIR : EI_BLANC;
+	EtatIntersection adversaire = noir ? EI_BLANC : EI_NOIR;
+
+	int k = indice(mouvement.intersection);
+	int representant = representants_[k];
+	int voisins[NB_D];
+	decalages(voisins);
+
+	// les pierres de la chaîne du coup devront être regroupées à
+	// nouveau, puisque la chaîne peut se séparer
+	std::vector<int>& aRecalculer = espace.pierres();
+	for (int p = suivantes_[k]; p != k; p = suivantes_[p]) {
+	    aRecalculer.push_back(p);
+	}
 
-	    aTraiter.pop(); //!\\ interCourante n'est plus valide à partir d'ici
+	// retrait de la pierre, qui redevient une liberté pour les
+	// chaînes adverses voisines encore en jeu
+	etats_[k] = EI_VIDE;
+	modifierMotifs(k, EI_VIDE);
+	ajouterVide(k);
+	pierres_[joueur].retirer(k);
+	modifierHashs(k, joueur);
+	for (int d = 0; d < NB_D; ++d) {
+	    int v = k + voisins[d];
+	    if (etats_[v] == adversaire) {
+		ajouterLiberte(v, k);
+	    }
+	}
 
-	    for (int k = 0; k < NB_D; ++k) {
-		Intersection& voisin = voisins[k];
-		EtatIntersection& etatVoisin = etat(voisin);
-		if (etatVoisin == defenseur) {
-		    etatVoisin = EI_VIDE;
-		    aTraiter.push(voisin);
+	// remise en place des prises, qui ôtent des libertés aux
+	// autres chaînes du joueur
+	int debut = prises.size() - mouvement.nbPrises;
+	for (int n = debut; n < (int) prises.size(); ++n) {
+	    int p = prises[n];
+	    etats_[p] = adversaire;
+	    modifierMotifs(p, adversaire);
+	    retirerVide(p);
+	    pierres_[adversaire].ajouter(p);
+	    modifierHashs(p, adversaire);
+	}
+	for (int n = debut; n < (int) prises.size(); ++n) {
+	    int p = prises[n];
+	    for (int d = 0; d < NB_D; ++d) {
+		int v = p + voisins[d];
+		if (etats_[v] == joueur && representants_[v] != representant) {
+		    retirerLiberte(v, p);
 		}
 	    }
+	    aRecalculer.push_back(p);
 	}
+	prises.resize(debut);
 
-	if (defenseur == EI_NOIR) {
-	    score().noir -= prisonniers;
+	recalculer(aRecalculer, espace.pile());
+	aRecalculer.clear();
+
+	ko_ = mouvement.ko;
+	score_.noir -= mouvement.deltaScore.noir;
+	score_.blanc -= mouvement.deltaScore.blanc;
+    }
+
+    void
+    EtatGoban::recalculer(const std::vector<int>& pierres,
+			  std::vector<int>& aTraiter)
+    {
+	int voisins[NB_D];
+	decalages(voisins);
+
+	std::vector<int>::const_iterator it;
+	for (it = pierres.begin(); it != pierres.end(); ++it) {
+	    representants_[*it] = -1;
 	}
-	else {
-	    score().blanc -= prisonniers;
+
+	for (it = pierres.begin(); it != pierres.end(); ++it) {
+	    int r = *it;
+	    if (representants_[r] != -1) {
+		continue;
+	    }
+
+	    // nouvelle chaîne représentée par la première pierre
+	    // rencontrée
+	    EtatIntersection couleur = etats_[r];
+	    Chaine& c = chaines_[r];
+	    c.nbPierres = 0;
+	    c.nbLibertes = 0;
+	    c.sommeLibertes = 0;
+	    c.sommeCarresLibertes = 0;
+	    representants_[r] = r;
+	    suivantes_[r] = r;
+	    aTraiter.push_back(r);
+
+	    while (!aTraiter.empty()) {
+		int p = aTraiter.back();
+		aTraiter.pop_back();
+
+		++c.nbPierres;
+		if (p != r) {
+		    suivantes_[p] = suivantes_[r];
+		    suivantes_[r] = p;
+		}
+
+		for (int d = 0; d < NB_D; ++d) {
+		    int v = p + voisins[d];
+		    if (etats_[v] == EI_VIDE) {
+			ajouterLiberte(r, v);
+		    }
+		    else if (etats_[v] == couleur && representants_[v] == -1) {
+			representants_[v] = r;
+			aTraiter.push_back(v);
+		    }
+		}
+	    }
 	}
     }
 
@@ -170,83 +498,98 @@ namespace jeu {
 	    out << std::endl;
 	}
 
-	out << "Blanc : " << score().blanc << std::endl;
-	out << "Noir : " << score().noir << std::endl;
+	out << "Blanc : " << score().blanc / 2.0 << std::endl;
+	out << "Noir : " << score().noir / 2.0 << std::endl;
     }
 
-    void
-    EtatGoban::finir(bool estimation)
+    Score
+    EtatGoban::scoreSurface() const
     {
-	static int idVisite(0);
-	static int idSousVisite(0);
-	static std::vector<int>
-	    visites(goban().taille() * goban().taille(),
-		    idVisite);
-
-	++idVisite;
+	const Bitboard& noirs = pierres_[EI_NOIR];
+	const Bitboard& blancs = pierres_[EI_BLANC];
+	Score score(2 * noirs.nbBits(),
+		    2 * blancs.nbBits() + goban().demiKomi());
+
+	// en fin de simulation, la plupart des intersections vides
+	// sont isolées : elles sont comptées directement d'après leurs
+	// voisins, et seules les zones plus grandes sont dilatées
+	Bitboard vides;
+	std::vector<int>::const_iterator it;
+	for (it = vides_.begin(); it != vides_.end(); ++it) {
+	    bool noir = false;
+	    bool blanc = false;
+	    bool vide = false;
+	    for (int d = 0; d < NB_D; ++d) {
+		EtatIntersection etatVoisin = etats_[*it + decalages_[d]];
+		noir = noir || etatVoisin == EI_NOIR;
+		blanc = blanc || etatVoisin == EI_BLANC;
+		vide = vide || etatVoisin == EI_VIDE;
+	    }
+	    if (vide) {
+		vides.ajouter(*it);
+	    }
+	    else if (noir && !blanc) {
+		score.noir += 2;
+	    }
+	    else if (blanc && !noir) {
+		score.blanc += 2;
+	    }
+	}
 
-	std::stack<Intersection> aTraiter;
-	Intersection voisins[NB_D];
+	Bitboard aTraiter(vides);
+	while (!aTraiter.vide()) {
+	    Bitboard zone(vides.composante(aTraiter.premier(), largeur_));
+	    aTraiter.sauf(zone);
 
-	Intersection inter;
-	for (inter.i = 0; inter.i < goban().taille(); ++inter.i) {
-	    for (inter.j = 0; inter.j < goban().taille(); ++inter.j) {
-		if (etat(inter) == EI_VIDE && visites[goban().id(inter)] != idVisite) {
-		    int nbVide = 0;
-		    int nbNoir = 0;
-		    int nbBlanc = 0;
-
-		    ++idSousVisite;
-		    visites[goban().id(inter)] = idVisite;
-		    aTraiter.push(inter);
-		    while (!aTraiter.empty()) {
-			Intersection& interCourante = aTraiter.top();
-			//std::cout << "nouvelle intersection vide : "
-			//	  << interCourante.i << ' '
-			//	  << interCourante.j << std::endl;
-			++nbVide;
-
-			interCourante.voisins(voisins);
-
-			aTraiter.pop(); //!\\ interCourante n'est plus valide à partir d'ici
-
-			for (int k = 0; k < NB_D; ++k) {
-			    Intersection& voisin = voisins[k];
-			    const EtatIntersection& etatVoisin = etat(voisin);
-			    int& visite = visites[goban().id(voisin)];
-			    if (etatVoisin == EI_NOIR && visite != idSousVisite) {
-				visite = idSousVisite;
-				++nbNoir;
-			    }
-			    else if (etatVoisin == EI_BLANC && visite != idSousVisite) {
-				visite = idSousVisite;
-				++nbBlanc;
-			    }
-			    else if (etatVoisin == EI_VIDE && visite != idVisite) {
-				visite = idVisite;
-				aTraiter.push(voisin);
-			    }
-			}
-		    }
+	    Bitboard bord(zone.dilatation(largeur_));
+	    bool noir = !(bord & noirs).vide();
+	    bool blanc = !(bord & blancs).vide();
+	    if (noir && !blanc) {
+		score.noir += 2 * zone.nbBits();
+	    }
+	    else if (blanc && !noir) {
+		score.blanc += 2 * zone.nbBits();
+	    }
+	}
 
-		    //std::cout << "nouveau territoire : "
-		    //        << nbVide << " v "
-		    //        << nbNoir << " n "
-		    //        << nbBlanc << " b "
-		    //        << std::endl;
+	return score;
+    }
 
-		    if (estimation) {
-			score().noir += (nbVide * nbNoir) / (nbNoir + nbBlanc);
-			score().blanc += (nbVide * nbBlanc) / (nbNoir + nbBlanc);
-		    }
-		    else if (nbNoir == 0 && nbBlanc > 0) {
-			score().blanc += nbVide;
-		    }
-		    else if (nbBlanc == 0 && nbNoir > 0) {
-			score().noir += nbVide;
-		    }
+    void
+    EtatGoban::finir(bool estimation)
+    {
+	int largeur = largeur_;
+	const Bitboard& noirs = pierres_[EI_NOIR];
+	const Bitboard& blancs = pierres_[EI_BLANC];
+
+	Bitboard vides(goban().plateau());
+	vides.sauf(noirs).sauf(blancs);
+
+	// chaque zone vide est obtenue d'un bloc par dilatations, et
+	// les pierres qui la bordent par une dernière dilatation
+	Bitboard aTraiter(vides);
+	while (!aTraiter.vide()) {
+	    Bitboard zone(vides.composante(aTraiter.premier(), largeur));
+	    aTraiter.sauf(zone);
+
+	    Bitboard bord(zone.dilatation(largeur));
+	    int nbVide = zone.nbBits();
+	    int nbNoir = (bord & noirs).nbBits();
+	    int nbBlanc = (bord & blancs).nbBits();
+
+	    if (estimation) {
+		int nbBord = nbNoir + nbBlanc;
+		if (nbBord > 0) {
+		    score().noir += (2 * nbVide * nbNoir) / nbBord;
+		    score().blanc += (2 * nbVide * nbBlanc) / nbBord;
 		}
 	    }
+	    else if (nbNoir == 0 && nbBlanc > 0) {
+		score().blanc += 2 * nbVide;
+	    }
+	    else if (nbBlanc == 0 && nbNoir > 0) {
+		score().noir += 2 * nbVide;
+	    }
 	}
     }
 
@@ -3,12 +3,58 @@
 
 #include <vector> // std::vector
 #include <ostream> // std::ostream
+#include <stdint.h> // uint64_t, uint32_t, uint16_t
 
 #include <jeu/types.hpp> // jeu::EtatIntersection, jeu::Intersection
 #include <jeu/goban.hpp> // jeu::Goban
+#include <jeu/symetrie.hpp> // jeu::Symetrie
+#include <jeu/bitboard.hpp> // jeu::Bitboard
+#include <jeu/espacetravail.hpp> // jeu::EspaceTravail
+#include <jeu/generateur.hpp> // jeu::Generateur
 
 namespace jeu {
 
+    /**
+     * \brief Structure enregistrant une pose de pierre afin de
+     *        pouvoir l'annuler.
+     *
+     * Les pierres capturées ne sont pas stockées dans la structure
+     * elle-même mais empilées dans une pile de prises commune à
+     * tout l'historique, ce qui évite une allocation par coup.
+     *
+     * @see EtatGoban::poser(const Intersection&, bool, Mouvement&, std::vector<int>&)
+     * @see EtatGoban::annuler(const Mouvement&, std::vector<int>&)
+     */
+    struct Mouvement {
+
+	/**
+	 * \brief Intersection où la pierre a été posée.
+	 */
+	Intersection intersection;
+
+	/**
+	 * \brief Couleur de la pierre posée.
+	 */
+	bool noir;
+
+	/**
+	 * \brief Intersection interdite par le ko avant le coup.
+	 */
+	int ko;
+
+	/**
+	 * \brief Nombre de pierres capturées par le coup, au sommet
+	 *        de la pile de prises.
+	 */
+	int nbPrises;
+
+	/**
+	 * \brief Variation du score due au coup.
+	 */
+	Score deltaScore;
+
+    };
+
     /**
      * \brief Classe représentant un état du goban.
      *
@@ -61,14 +107,15 @@ namespace jeu {
 	 * \brief Accès à l'état d'une intersection.
 	 *
 	 * L'état de cette intersection pourra être modifié grâce à la
-	 * référence qui est retournée.
+	 * référence qui est retournée. Une telle modification ne met
+	 * pas à jour les chaînes : elle est réservée à l'affichage et
+	 * l'état ne doit plus ensuite être passé à poser() ou tuer().
 	 */
 	inline
 	EtatIntersection&
 	etat(const Intersection& inter)
 	{
-	    int k = (inter.i + 1) + (goban().taille() + 2) * (inter.j + 1);
-	    return etats_[k];
+	    return etats_[indice(inter)];
 	}
 
 	/**
@@ -81,8 +128,7 @@ namespace jeu {
 	const EtatIntersection&
 	etat(const Intersection& inter) const
 	{
-	    int k = (inter.i + 1) + (goban().taille() + 2) * (inter.j + 1);
-	    return etats_[k];
+	    return etats_[indice(inter)];
 	}
 
 	/**
@@ -137,6 +183,136 @@ namespace jeu {
 	bool
 	poser(const Intersection& inter, bool pierreNoire);
 
+	/**
+	 * \brief Pose d'une pierre avec enregistrement du coup.
+	 *
+	 * Cette fonction se comporte comme
+	 * poser(const Intersection&, bool), mais remplit en plus le
+	 * mouvement passé en paramètre et empile les pierres capturées
+	 * sur la pile de prises, afin que le coup puisse être annulé.
+	 *
+	 * @see annuler(const Mouvement&, std::vector<int>&)
+	 */
+	bool
+	poser(const Intersection& inter, bool pierreNoire,
+	      Mouvement& mouvement, std::vector<int>& prises);
+
+	/**
+	 * \brief Annulation du dernier coup enregistré.
+	 *
+	 * La pierre est retirée, les pierres capturées sont dépilées
+	 * et remises en place, puis les chaînes touchées sont
+	 * recalculées. Les coups doivent être annulés dans l'ordre
+	 * inverse de celui où ils ont été joués.
+	 *
+	 * Les tableaux de travail du recalcul sont ceux du thread
+	 * appelant.
+	 *
+	 * @see EspaceTravail::local(const Goban&)
+	 */
+	void
+	annuler(const Mouvement& mouvement, std::vector<int>& prises);
+
+	/**
+	 * \brief Annulation du dernier coup enregistré avec un espace
+	 *        de travail fourni par l'appelant.
+	 *
+	 * @see annuler(const Mouvement&, std::vector<int>&)
+	 */
+	void
+	annuler(const Mouvement& mouvement, std::vector<int>& prises,
+		EspaceTravail& espace);
+
+	/**
+	 * \brief Savoir si une intersection est interdite par la
+	 *        règle du ko simple.
+	 *
+	 * Une intersection est interdite lorsque le dernier coup a
+	 * capturé une unique pierre à cet endroit avec une pierre
+	 * seule qui se retrouve en atari. La règle n'est pas appliquée
+	 * par poser(), c'est au code appelant de la faire respecter.
+	 */
+	inline
+	bool
+	ko(const Intersection& inter) const
+	{
+	    return ko_ == indice(inter);
+	}
+
+	/**
+	 * \brief Savoir si un coup est licite.
+	 *
+	 * Un coup est licite si l'intersection est vide, n'est pas
+	 * interdite par le ko simple et n'est pas un suicide. La
+	 * vérification se fait en temps constant à partir des
+	 * libertés des chaînes voisines.
+	 *
+	 * @see ko(const Intersection&) const
+	 */
+	inline
+	bool
+	licite(const Intersection& inter, bool pierreNoire) const
+	{
+	    return licite(indice(inter), pierreNoire);
+	}
+
+	/**
+	 * \brief Liste des coups licites pour un joueur.
+	 *
+	 * La liste est construite à partir de celle des intersections
+	 * vides, sans parcourir le goban.
+	 */
+	std::vector<Intersection>
+	coupsLicites(bool pierreNoire) const;
+
+	/**
+	 * \brief Tirage uniforme d'un coup licite.
+	 *
+	 * Les intersections vides sont tirées sans remise jusqu'à en
+	 * trouver une licite ; chaque essai coûte un temps constant.
+	 * S'il n'existe aucun coup licite, le coup retourné consiste
+	 * à passer.
+	 *
+	 * Si demandé, les coups remplissant un œil du joueur sont
+	 * écartés comme les coups illicites : sans cela, un joueur
+	 * aléatoire finit par boucher ses propres yeux et les parties
+	 * ne se terminent plus.
+	 *
+	 * L'ordre interne des intersections vides est modifié, mais
+	 * pas l'état du goban.
+	 *
+	 * @see oeil(const Intersection&, bool) const
+	 */
+	Coup
+	coupAleatoire(bool pierreNoire, Generateur& generateur,
+		      bool eviterYeux = false);
+
+	/**
+	 * \brief Savoir si une intersection vide est un œil d'un
+	 *        joueur.
+	 *
+	 * Il s'agit d'une détection rapide : les quatre voisins
+	 * doivent être des pierres du joueur ou le bord, et au plus
+	 * une diagonale (aucune au bord du goban) peut porter une
+	 * pierre adverse.
+	 */
+	inline
+	bool
+	oeil(const Intersection& inter, bool pierreNoire) const
+	{
+	    return oeil(indice(inter), pierreNoire);
+	}
+
+	/**
+	 * \brief Nombre d'intersections vides.
+	 */
+	inline
+	int
+	nbVides() const
+	{
+	    return vides_.size();
+	}
+
 	/**
 	 * \brief Vérification de l'absence de degré de liberté sur
 	 *        une chaîne.
@@ -146,11 +322,112 @@ namespace jeu {
 	 * paramètre est morte, c'est-à-dire si elle n'a plus aucun
 	 * degré de liberté.
 	 *
+	 * Les libertés des chaînes étant maintenues à chaque coup,
+	 * cette vérification se fait en temps constant.
+	 *
+	 * @see libertes(const Intersection&) const
 	 * @see tuer(const Intersection&)
 	 */
 	bool
 	mort(const Intersection& inter) const;
 
+	/**
+	 * \brief Nombre de pseudo-libertés d'une chaîne.
+	 *
+	 * Une pseudo-liberté est un couple (pierre, intersection vide
+	 * voisine) : une intersection vide touchant plusieurs pierres
+	 * de la chaîne est donc comptée plusieurs fois. Ce nombre est
+	 * nul si et seulement si la chaîne est morte, et il est
+	 * maintenu au fil des coups, si bien que cette fonction ne
+	 * parcourt jamais la chaîne.
+	 *
+	 * L'intersection passée en paramètre doit porter une pierre.
+	 */
+	inline
+	int
+	libertes(const Intersection& inter) const
+	{
+	    return chaine(indice(inter)).nbLibertes;
+	}
+
+	/**
+	 * \brief Savoir si la chaîne d'une pierre est en atari,
+	 *        c'est-à-dire n'a plus qu'une liberté.
+	 *
+	 * L'intersection passée en paramètre doit porter une pierre.
+	 */
+	inline
+	bool
+	atari(const Intersection& inter) const
+	{
+	    return atari(indice(inter));
+	}
+
+	/**
+	 * \brief Dernière liberté d'une chaîne en atari.
+	 *
+	 * @see atari(const Intersection&) const
+	 */
+	inline
+	Intersection
+	liberte(const Intersection& inter) const
+	{
+	    return intersection(liberte(indice(inter)));
+	}
+
+	/**
+	 * \brief Savoir si poser sur une intersection vide mettrait
+	 *        probablement la chaîne formée en atari.
+	 *
+	 * Il s'agit d'une estimation en temps constant : une chaîne
+	 * amie voisine qui n'est pas en atari, ou une capture, sont
+	 * supposées apporter une seconde liberté.
+	 */
+	inline
+	bool
+	autoAtari(const Intersection& inter, bool pierreNoire) const
+	{
+	    return autoAtari(indice(inter), pierreNoire);
+	}
+
+	/**
+	 * \brief Nombre de voisins d'une intersection décrits par
+	 *        son motif.
+	 */
+	static const int NB_VOISINS_MOTIF = 8;
+
+	/**
+	 * \brief Motif formé par les huit voisins d'une
+	 *        intersection.
+	 *
+	 * Le voisin v, numéroté de 0 à 7 dans l'ordre de lecture
+	 * d'un carré de 3x3 intersections dont on a ôté le centre
+	 * (lignes selon i, colonnes selon j), occupe les bits 2v et
+	 * 2v + 1, qui contiennent son EtatIntersection. Les bits 16 à
+	 * 19 indiquent si la chaîne de chacun des quatre voisins
+	 * orthogonaux, pris dans le même ordre, est en atari.
+	 *
+	 * Les états des voisins sont mis à jour à chaque pierre posée
+	 * ou retirée, alors que les ataris sont lus au moment de
+	 * l'appel sur les chaînes voisines.
+	 */
+	inline
+	uint32_t
+	motif(const Intersection& inter) const
+	{
+	    static const int orthogonaux[NB_D] = {1, 3, 4, 6};
+	    int k = indice(inter);
+	    uint32_t m = motifs_[k];
+	    for (int a = 0; a < NB_D; ++a) {
+		int p = k + decalagesMotif_[orthogonaux[a]];
+		if ((etats_[p] == EI_NOIR || etats_[p] == EI_BLANC) &&
+		    atari(p)) {
+		    m |= 1 << (2 * NB_VOISINS_MOTIF + a);
+		}
+	    }
+	    return m;
+	}
+
 
 	/**
 	 * \brief Retrait d'une chaîne.
@@ -165,6 +442,30 @@ namespace jeu {
 	void
 	tuer(const Intersection& inter);
 
+	/**
+	 * \brief Prise en compte d'un coup où le joueur passe.
+	 *
+	 * Passer lève l'interdiction due au ko simple.
+	 */
+	inline
+	void
+	passer()
+	{
+	    ko_ = -1;
+	}
+
+	/**
+	 * \brief Décompte des points par surface.
+	 *
+	 * Chaque joueur marque ses pierres sur le goban et les zones
+	 * vides bordées uniquement par ses pierres ; le komi est
+	 * ajouté à blanc. L'état n'est pas modifié.
+	 *
+	 * @see finir(bool)
+	 */
+	Score
+	scoreSurface() const;
+
         /**
 	 * \brief Décompte des points de territoire.
 	 *
@@ -174,6 +475,94 @@ namespace jeu {
 	void
 	finir(bool estimation = false);
 
+	/**
+	 * \brief Ensemble des pierres d'un joueur.
+	 *
+	 * @see Bitboard
+	 */
+	inline
+	const Bitboard&
+	pierres(bool noir) const
+	{
+	    return pierres_[noir ? EI_NOIR : EI_BLANC];
+	}
+
+	/**
+	 * \brief Hachage de Zobrist de la position.
+	 *
+	 * Ce hachage ne dépend que des pierres présentes sur le goban
+	 * et est mis à jour à chaque pose ou retrait de pierre. Deux
+	 * états égaux ont le même hachage.
+	 */
+	inline
+	uint64_t
+	hash() const
+	{
+	    return hashs_[0];
+	}
+
+	/**
+	 * \brief Hachage de Zobrist de la position et du joueur qui a
+	 *        le trait.
+	 */
+	inline
+	uint64_t
+	hash(bool tourNoir) const
+	{
+	    return tourNoir ? hashs_[0] ^ CLE_TOUR_NOIR : hashs_[0];
+	}
+
+	/**
+	 * \brief Hachage de Zobrist de l'image de la position par une
+	 *        symétrie.
+	 *
+	 * Les hachages des Symetrie::NB images sont tenus à jour en
+	 * même temps que celui de la position.
+	 */
+	inline
+	uint64_t
+	hash(const Symetrie& symetrie) const
+	{
+	    return hashs_[symetrie.code()];
+	}
+
+	/**
+	 * \brief Hachage de la forme canonique de la position, joueur
+	 *        qui a le trait compris.
+	 *
+	 * La forme canonique est l'image de la position dont le
+	 * hachage est le plus petit : toutes les positions symétriques
+	 * l'une de l'autre ont la même. La symétrie passée en
+	 * paramètre reçoit celle qui envoie la position sur sa forme
+	 * canonique ; sa réciproque ramène les coups de la forme
+	 * canonique dans la position.
+	 */
+	inline
+	uint64_t
+	hashCanonique(bool tourNoir, Symetrie& symetrie) const
+	{
+	    int s = 0;
+	    for (int t = 1; t < Symetrie::NB; ++t) {
+		if (hashs_[t] < hashs_[s]) {
+		    s = t;
+		}
+	    }
+	    symetrie = Symetrie(s);
+	    return tourNoir ? hashs_[s] ^ CLE_TOUR_NOIR : hashs_[s];
+	}
+
+	/**
+	 * \brief Hachage de la forme canonique de la position, sans
+	 *        la symétrie correspondante.
+	 */
+	inline
+	uint64_t
+	hashCanonique(bool tourNoir) const
+	{
+	    Symetrie symetrie;
+	    return hashCanonique(tourNoir, symetrie);
+	}
+
 	/**
 	 * \brief Accès au goban utilisé.
 	 *
@@ -211,16 +600,482 @@ namespace jeu {
 
     private:
 
+	/**
+	 * \brief Informations maintenues pour chaque chaîne.
+	 *
+	 * Les libertés sont des pseudo-libertés. Leur somme et la
+	 * somme de leurs carrés permettent de savoir en temps constant
+	 * si elles désignent toutes la même intersection, c'est-à-dire
+	 * si la chaîne est en atari.
+	 */
+	struct Chaine {
+	    int nbPierres;
+	    int nbLibertes;
+	    int sommeLibertes;
+	    int sommeCarresLibertes;
+	};
+
+	/**
+	 * \brief Clé de Zobrist ajoutée au hachage quand noir a le
+	 *        trait.
+	 */
+	static const uint64_t CLE_TOUR_NOIR = 0x9e3779b97f4a7c15ULL;
+
+	/**
+	 * \brief Clé de Zobrist d'une pierre.
+	 *
+	 * Les clés sont calculées à la demande par un mélange de bits
+	 * (splitmix64) de l'indice et de la couleur, ce qui évite une
+	 * table dépendant de la taille du goban.
+	 */
+	static inline
+	uint64_t
+	cle(int k, EtatIntersection couleur)
+	{
+	    uint64_t x = 2 * (uint64_t) k + couleur + 1;
+	    x *= CLE_TOUR_NOIR;
+	    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	    return x ^ (x >> 31);
+	}
+
+	/**
+	 * \brief Indice d'une intersection dans les tableaux internes.
+	 *
+	 * Les tableaux internes comportent une bordure d'une
+	 * intersection tout autour du goban.
+	 */
+	inline
+	int
+	indice(const Intersection& inter) const
+	{
+	    return (inter.i + 1) + largeur_ * (inter.j + 1);
+	}
+
+	/**
+	 * \brief Remplissage des décalages d'indice vers les voisins.
+	 *
+	 * Les décalages sont recopiés dans un tableau local afin que
+	 * le compilateur puisse les garder en registre dans les
+	 * boucles sur les voisins.
+	 *
+	 * @see Intersection::voisins(Intersection[NB_D]) const
+	 */
+	inline
+	void
+	decalages(int decalages[NB_D]) const
+	{
+	    for (int d = 0; d < NB_D; ++d) {
+		decalages[d] = decalages_[d];
+	    }
+	}
+
+	/**
+	 * \brief Intersection correspondant à un indice des tableaux
+	 *        internes.
+	 */
+	inline
+	Intersection
+	intersection(int k) const
+	{
+	    return Intersection(k % largeur_ - 1, k / largeur_ - 1);
+	}
+
+	/**
+	 * \brief Savoir si poser sur une intersection vide serait un
+	 *        suicide.
+	 */
+	inline
+	bool
+	suicide(int k, bool pierreNoire) const
+	{
+	    EtatIntersection joueur = pierreNoire ? EI_NOIR : EI_BLANC;
+	    EtatIntersection adversaire = pierreNoire ? EI_BLANC : EI_NOIR;
+
+	    // il reste une liberté à la chaîne formée, ou une chaîne
+	    // adverse voisine en atari est capturée
+	    for (int d = 0; d < NB_D; ++d) {
+		int v = k + decalages_[d];
+		EtatIntersection etatVoisin = etats_[v];
+		if (etatVoisin == EI_VIDE ||
+		    (etatVoisin == joueur && !atari(v)) ||
+		    (etatVoisin == adversaire && atari(v))) {
+		    return false;
+		}
+	    }
+	    return true;
+	}
+
+	/**
+	 * \brief Savoir si une intersection repérée par son indice
+	 *        est un œil d'un joueur.
+	 *
+	 * @see oeil(const Intersection&, bool) const
+	 */
+	inline
+	bool
+	oeil(int k, bool pierreNoire) const
+	{
+	    EtatIntersection joueur = pierreNoire ? EI_NOIR : EI_BLANC;
+	    EtatIntersection adversaire = pierreNoire ? EI_BLANC : EI_NOIR;
+
+	    for (int d = 0; d < NB_D; ++d) {
+		EtatIntersection etatVoisin = etats_[k + decalages_[d]];
+		if (etatVoisin != joueur && etatVoisin != EI_GRIS) {
+		    return false;
+		}
+	    }
+
+	    int diagonales[4] = {
+		k - largeur_ - 1, k - largeur_ + 1,
+		k + largeur_ - 1, k + largeur_ + 1
+	    };
+	    int nbAdverses = 0;
+	    int nbBords = 0;
+	    for (int d = 0; d < 4; ++d) {
+		EtatIntersection etatDiagonale = etats_[diagonales[d]];
+		if (etatDiagonale == adversaire) {
+		    ++nbAdverses;
+		}
+		else if (etatDiagonale == EI_GRIS) {
+		    ++nbBords;
+		}
+	    }
+	    return nbAdverses + (nbBords > 0 ? 1 : 0) < 2;
+	}
+
+	/**
+	 * \brief Savoir si un coup repéré par son indice est licite.
+	 *
+	 * @see licite(const Intersection&, bool) const
+	 */
+	inline
+	bool
+	licite(int k, bool pierreNoire) const
+	{
+	    return etats_[k] == EI_VIDE && k != ko_ && !suicide(k, pierreNoire);
+	}
+
+	/**
+	 * \brief Ajout d'une intersection à la liste des vides.
+	 */
+	inline
+	void
+	ajouterVide(int k)
+	{
+	    positionsVides_[k] = vides_.size();
+	    vides_.push_back(k);
+	}
+
+	/**
+	 * \brief Retrait d'une intersection de la liste des vides.
+	 *
+	 * La dernière intersection de la liste prend sa place.
+	 */
+	inline
+	void
+	retirerVide(int k)
+	{
+	    int derniere = vides_.back();
+	    vides_[positionsVides_[k]] = derniere;
+	    positionsVides_[derniere] = positionsVides_[k];
+	    vides_.pop_back();
+	}
+
+	/**
+	 * \brief Calcul de la géométrie des tableaux internes pour le
+	 *        goban utilisé.
+	 */
+	void
+	initialiserGeometrie();
+
+	/**
+	 * \brief Accès aux informations de la chaîne d'une pierre.
+	 */
+	inline
+	Chaine&
+	chaine(int k)
+	{
+	    return chaines_[representants_[k]];
+	}
+
+	/**
+	 * \brief Accès aux informations de la chaîne d'une pierre
+	 *        depuis un objet const.
+	 */
+	inline
+	const Chaine&
+	chaine(int k) const
+	{
+	    return chaines_[representants_[k]];
+	}
+
+	/**
+	 * \brief Savoir si la chaîne d'une pierre est en atari.
+	 */
+	inline
+	bool
+	atari(int k) const
+	{
+	    const Chaine& c = chaine(k);
+	    return (long long) c.nbLibertes * c.sommeCarresLibertes
+		== (long long) c.sommeLibertes * c.sommeLibertes;
+	}
+
+	/**
+	 * \brief Dernière liberté de la chaîne d'une pierre en atari.
+	 *
+	 * Toutes les pseudo-libertés d'une chaîne en atari étant la
+	 * même intersection, leur moyenne la donne.
+	 */
+	inline
+	int
+	liberte(int k) const
+	{
+	    const Chaine& c = chaine(k);
+	    return c.sommeLibertes / c.nbLibertes;
+	}
+
+	/**
+	 * \brief Savoir si poser sur une intersection repérée par son
+	 *        indice mettrait probablement la chaîne en atari.
+	 *
+	 * @see autoAtari(const Intersection&, bool) const
+	 */
+	inline
+	bool
+	autoAtari(int k, bool pierreNoire) const
+	{
+	    EtatIntersection joueur = pierreNoire ? EI_NOIR : EI_BLANC;
+	    EtatIntersection adversaire = pierreNoire ? EI_BLANC : EI_NOIR;
+	    int seule = -1;
+	    for (int d = 0; d < NB_D; ++d) {
+		int v = k + decalages_[d];
+		EtatIntersection etatVoisin = etats_[v];
+		int l;
+		if (etatVoisin == EI_VIDE) {
+		    l = v;
+		}
+		else if (etatVoisin == joueur) {
+		    if (!atari(v)) {
+			return false;
+		    }
+		    l = liberte(v);
+		    if (l == k) {
+			continue;
+		    }
+		}
+		else if (etatVoisin == adversaire && atari(v)) {
+		    return false;
+		}
+		else {
+		    continue;
+		}
+
+		if (seule >= 0 && seule != l) {
+		    return false;
+		}
+		seule = l;
+	    }
+	    return true;
+	}
+
+	/**
+	 * \brief Mise à jour des motifs des voisins d'une
+	 *        intersection dont l'état change.
+	 */
+	inline
+	void
+	modifierMotifs(int k, EtatIntersection etat)
+	{
+	    for (int v = 0; v < NB_VOISINS_MOTIF; ++v) {
+		uint16_t& m = motifs_[k - decalagesMotif_[v]];
+		m = (m & ~(3 << (2 * v))) | (etat << (2 * v));
+	    }
+	}
+
+	/**
+	 * \brief Mise à jour des hachages de la position et de ses
+	 *        images lorsqu'une pierre est posée ou retirée.
+	 */
+	inline
+	void
+	modifierHashs(int k, EtatIntersection couleur)
+	{
+	    const int* images = goban_->symetriques(k);
+	    for (int s = 0; s < Symetrie::NB; ++s) {
+		hashs_[s] ^= cle(images[s], couleur);
+	    }
+	}
+
+	/**
+	 * \brief Calcul de tous les motifs à partir des états.
+	 */
+	void
+	initialiserMotifs();
+
+	/**
+	 * \brief Ajout d'une pseudo-liberté à la chaîne d'une pierre.
+	 */
+	inline
+	void
+	ajouterLiberte(int k, int liberte)
+	{
+	    Chaine& c = chaine(k);
+	    ++c.nbLibertes;
+	    c.sommeLibertes += liberte;
+	    c.sommeCarresLibertes += liberte * liberte;
+	}
+
+	/**
+	 * \brief Retrait d'une pseudo-liberté à la chaîne d'une pierre.
+	 */
+	inline
+	void
+	retirerLiberte(int k, int liberte)
+	{
+	    Chaine& c = chaine(k);
+	    --c.nbLibertes;
+	    c.sommeLibertes -= liberte;
+	    c.sommeCarresLibertes -= liberte * liberte;
+	}
+
+	/**
+	 * \brief Fusion des chaînes de deux pierres.
+	 *
+	 * La plus petite des deux chaînes est renumérotée.
+	 */
+	void
+	fusionner(int k1, int k2);
+
+	/**
+	 * \brief Retrait de la chaîne d'une pierre repérée par son
+	 *        indice.
+	 *
+	 * @see tuer(const Intersection&)
+	 */
+	void
+	tuer(int k, std::vector<int>* prises = NULL);
+
+	/**
+	 * \brief Pose d'une pierre repérée par son indice.
+	 *
+	 * Les pierres capturées sont empilées sur la pile de prises si
+	 * celle-ci est fournie.
+	 *
+	 * @see poser(const Intersection&, bool)
+	 */
+	bool
+	poser(int k, bool pierreNoire, std::vector<int>* prises);
+
+	/**
+	 * \brief Recalcul complet des chaînes passant par des pierres
+	 *        marquées.
+	 *
+	 * Les pierres à traiter sont celles dont le représentant vaut
+	 * -1 ; les listes de pierres et les libertés de leurs chaînes
+	 * sont reconstruites par parcours.
+	 */
+	void
+	recalculer(const std::vector<int>& pierres, std::vector<int>& pile);
+
 	/**
 	 * \brief Pointeur vers le goban utilisé.
 	 */
 	const Goban* goban_;
 
+	/**
+	 * \brief Largeur d'une ligne des tableaux internes, bordure
+	 *        comprise.
+	 *
+	 * Elle est conservée ici pour que l'accès à une intersection
+	 * ne passe pas par le goban. Une largeur et des décalages
+	 * fixés à la compilation, essayés pour 9 et pour 19, ne font
+	 * pas mieux sur bench/regles que le bruit de la mesure.
+	 */
+	int largeur_;
+
+	/**
+	 * \brief Décalages d'indice vers les voisins, indexés par
+	 *        direction.
+	 */
+	int decalages_[NB_D];
+
+	/**
+	 * \brief Décalages d'indice vers les huit voisins décrits
+	 *        par les motifs, dans l'ordre des motifs.
+	 */
+	int decalagesMotif_[NB_VOISINS_MOTIF];
+
 	/**
 	 * \brief Tableau stockant l'état des intersections.
 	 */
 	std::vector<EtatIntersection> etats_;
 
+	/**
+	 * \brief Représentant de la chaîne de chaque pierre.
+	 *
+	 * Le représentant d'une chaîne est l'indice de l'une de ses
+	 * pierres. Il n'a pas de sens pour une intersection vide.
+	 */
+	std::vector<int> representants_;
+
+	/**
+	 * \brief Pierre suivante dans la chaîne de chaque pierre.
+	 *
+	 * Les pierres d'une chaîne forment une liste circulaire.
+	 */
+	std::vector<int> suivantes_;
+
+	/**
+	 * \brief Informations des chaînes, rangées à l'indice de leur
+	 *        représentant.
+	 */
+	std::vector<Chaine> chaines_;
+
+	/**
+	 * \brief Liste des intersections vides du goban, dans un
+	 *        ordre quelconque.
+	 */
+	std::vector<int> vides_;
+
+	/**
+	 * \brief Position de chaque intersection vide dans la liste
+	 *        des vides.
+	 */
+	std::vector<int> positionsVides_;
+
+	/**
+	 * \brief États des huit voisins de chaque intersection, sans
+	 *        les ataris.
+	 *
+	 * @see motif(const Intersection&) const
+	 */
+	std::vector<uint16_t> motifs_;
+
+	/**
+	 * \brief Ensembles des pierres noires et blanches, indexés par
+	 *        EI_NOIR et EI_BLANC.
+	 *
+	 * Ils doublent le tableau des états pour les traitements
+	 * portant sur des zones entières, comme le décompte des
+	 * territoires.
+	 */
+	Bitboard pierres_[2];
+
+	/**
+	 * \brief Hachages de Zobrist des pierres posées, pour la
+	 *        position et pour ses images par chaque symétrie.
+	 *
+	 * @see hash(const Symetrie&) const
+	 */
+	uint64_t hashs_[Symetrie::NB];
+
+	/**
+	 * \brief Indice de l'intersection interdite par le ko, ou -1.
+	 */
+	int ko_;
+
 	/**
 	 * \brief Score actuel.
 	 */
@@ -246,11 +1101,15 @@ namespace jeu {
      * Deux états sont égaux si et seulement si ils utilisent le même
      * goban et toutes les intersections sont dans le même état.
      *
-     * Le score n'est pas pris en compte dans la comparaison.
+     * Le score n'est pas pris en compte dans la comparaison. Les
+     * hachages sont comparés en premier : les ensembles de pierres
+     * ne sont comparés qu'en cas de collision.
      */
     inline bool operator==(const EtatGoban& e1, const EtatGoban& e2)
     {
-	return e1.goban_ == e2.goban_ && e1.etats_ == e2.etats_;
+	return e1.hashs_[0] == e2.hashs_[0] && e1.goban_ == e2.goban_
+	    && e1.pierres_[EI_NOIR] == e2.pierres_[EI_NOIR]
+	    && e1.pierres_[EI_BLANC] == e2.pierres_[EI_BLANC];
     }
 
 }
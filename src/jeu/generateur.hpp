@@ -0,0 +1,83 @@
+#ifndef JEU_GENERATEUR_HPP
+#define JEU_GENERATEUR_HPP
+
+#include <stdint.h> // uint64_t, uint32_t
+
+namespace jeu {
+
+    /**
+     * \brief Générateur de nombres pseudo-aléatoires rapide.
+     *
+     * Il s'agit d'un générateur xorshift64* : son état tient dans un
+     * entier de 64 bits, ce qui permet à chaque joueur ou à chaque
+     * thread d'avoir le sien, contrairement à rand() dont l'état
+     * est global.
+     */
+    class Generateur {
+
+    public:
+
+	/**
+	 * \brief Constructeur de générateur à partir d'une graine.
+	 *
+	 * La graine est mélangée (splitmix64) afin que des graines
+	 * proches, comme des numéros de thread, donnent des suites
+	 * indépendantes.
+	 */
+	explicit
+	Generateur(uint64_t graine = 0)
+	{
+	    uint64_t x = graine + 0x9e3779b97f4a7c15ULL;
+	    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	    etat_ = (x ^ (x >> 31)) | 1;
+	}
+
+	/**
+	 * \brief Tirage d'un entier de 64 bits.
+	 */
+	inline
+	uint64_t
+	operator()()
+	{
+	    etat_ ^= etat_ >> 12;
+	    etat_ ^= etat_ << 25;
+	    etat_ ^= etat_ >> 27;
+	    return etat_ * 0x2545f4914f6cdd1dULL;
+	}
+
+	/**
+	 * \brief Tirage d'un entier entre 0 et n - 1.
+	 *
+	 * Le tirage se fait par multiplication plutôt que par modulo,
+	 * ce qui évite une division.
+	 */
+	inline
+	int
+	entier(int n)
+	{
+	    return (int) (((uint64_t) (uint32_t) ((*this)() >> 32) * n) >> 32);
+	}
+
+	/**
+	 * \brief Tirage d'un réel entre 0 inclus et 1 exclu.
+	 */
+	inline
+	double
+	reel()
+	{
+	    return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+    private:
+
+	/**
+	 * \brief État du générateur, jamais nul.
+	 */
+	uint64_t etat_;
+
+    };
+
+}
+
+#endif
@@ -1,6 +1,11 @@
 #include <algorithm> // std::copy, std::find
+#include <list> // std::list
+#include <mutex> // std::mutex, std::lock_guard
+#include <stdexcept> // std::invalid_argument
 
 #include <jeu/types.hpp> // jeu::Intersection
+#include <jeu/symetrie.hpp> // jeu::Symetrie
+#include <jeu/bitboard.hpp> // jeu::Bitboard
 
 #include <jeu/goban.hpp> // jeu::Goban
 
@@ -46,11 +51,16 @@ namespace jeu {
     };
 
 
-    Goban::Goban(int taille = 19)
+    Goban::Goban(int taille, int demiKomi)
 	: taille_(taille),
-	  komi_(0),
-	  hoshi_(0, Intersection())
+	  demiKomi_(demiKomi),
+	  hoshi_(0, Intersection()),
+	  plateau_(),
+	  symetriques_()
     {
+	initialiserPlateau();
+	initialiserSymetriques();
+
 	if (taille == 19) {
 	    hoshi_.resize(ARRAY_SIZE(hoshi19));
 	    std::copy(hoshi19, hoshi19 + ARRAY_SIZE(hoshi19),
@@ -68,6 +78,39 @@ namespace jeu {
 	}
     }
 
+    void
+    Goban::initialiserPlateau()
+    {
+	// au-delà, le plateau déborderait des bitboards
+	if (taille_ < 1 || taille_ > Bitboard::TAILLE_MAX) {
+	    throw std::invalid_argument("taille de goban invalide");
+	}
+
+	for (int j = 0; j < taille_; ++j) {
+	    for (int i = 0; i < taille_; ++i) {
+		plateau_.ajouter((i + 1) + (taille_ + 2) * (j + 1));
+	    }
+	}
+    }
+
+    void
+    Goban::initialiserSymetriques()
+    {
+	int largeur = taille_ + 2;
+	symetriques_.resize(Symetrie::NB * largeur * largeur);
+	for (int k = 0; k < largeur * largeur; ++k) {
+	    Intersection inter(k % largeur - 1, k / largeur - 1);
+	    bool bordure = inter.i < 0 || inter.i >= taille_
+		|| inter.j < 0 || inter.j >= taille_;
+	    for (int s = 0; s < Symetrie::NB; ++s) {
+		Intersection image = bordure ? inter
+		    : Symetrie(s).appliquer(inter, taille_);
+		symetriques_[Symetrie::NB * k + s] =
+		    (image.i + 1) + largeur * (image.j + 1);
+	    }
+	}
+    }
+
     bool
     Goban::hoshi(const Intersection& inter) const
     {
@@ -75,4 +118,24 @@ namespace jeu {
 	    std::find(hoshi_.begin(), hoshi_.end(), inter);
     }
 
+    Gobans::Gobans()
+	: gobans_(),
+	  mutex_()
+    {
+    }
+
+    const Goban&
+    Gobans::goban(int taille, int demiKomi)
+    {
+	std::lock_guard<std::mutex> verrou(mutex_);
+	for (std::list<Goban>::const_iterator it = gobans_.begin();
+	     it != gobans_.end(); ++it) {
+	    if (it->taille() == taille && it->demiKomi() == demiKomi) {
+		return *it;
+	    }
+	}
+	gobans_.push_back(Goban(taille, demiKomi));
+	return gobans_.back();
+    }
+
 }
@@ -2,10 +2,12 @@
 #define JEU_GOBAN_HPP
 
 #include <list> // std::list
+#include <mutex> // std::mutex
+#include <vector> // std::vector
 
 #include <jeu/types.hpp> // jeu::Intersection
-
-// todo : gérer le komi
+#include <jeu/bitboard.hpp> // jeu::Bitboard
+#include <jeu/symetrie.hpp> // jeu::Symetrie
 
 namespace jeu {
 
@@ -18,7 +20,8 @@ namespace jeu {
      * aux alentours desquelles il est conseillé de jouer en début de
      * partie, ainsi que le komi : le nombre de points attribués au
      * joueur blanc pour compenser le fait que le joueur noir commence
-     * la partie.
+     * la partie. Le komi est compté en demi-points, comme les scores,
+     * afin de pouvoir comporter un demi-point.
      */
     class Goban {
 
@@ -30,8 +33,12 @@ namespace jeu {
 	 * Les hoshi sont calculés directement en fonction de la
 	 * taille passé en argument si celle-ci est commune,
 	 * c'est-à-dire 9, 13 ou 19.
+	 *
+	 * La taille doit être comprise entre 1 et
+	 * Bitboard::TAILLE_MAX, sans quoi std::invalid_argument est
+	 * levée.
 	 */
-	Goban(int taille);
+	Goban(int taille, int demiKomi = 0);
 
 	/**
 	 * \brief Constructeur de goban à partir de taille et
@@ -41,14 +48,21 @@ namespace jeu {
 	 *   int taille;
 	 *   std::vector<jeu::Intersection> hoshi(4);
 	 *   jeu::Goban goban(taille, hoshi.begin(), hoshi.end());
+	 *
+	 * La taille est soumise à la même limite que pour le
+	 * constructeur par taille.
 	 */
 	template <typename IterIntersection>
-	Goban(int taille, int komi, IterIntersection premierHoshi,
+	Goban(int taille, int demiKomi, IterIntersection premierHoshi,
 	      IterIntersection dernierHoshi)
 	    : taille_(taille),
-	      komi_(komi),
-	      hoshi_(premierHoshi, dernierHoshi)
+	      demiKomi_(demiKomi),
+	      hoshi_(premierHoshi, dernierHoshi),
+	      plateau_(),
+	      symetriques_()
 	{
+	    initialiserPlateau();
+	    initialiserSymetriques();
 	}
 
 	/**
@@ -82,27 +96,69 @@ namespace jeu {
 	}
 
 	/**
-	 * \brief Accès au komi.
+	 * \brief Accès au komi, en demi-points.
 	 */
 	inline
 	int
-	komi() const
+	demiKomi() const
+	{
+	    return demiKomi_;
+	}
+
+	/**
+	 * \brief Ensemble des intersections du goban, bordure exclue.
+	 *
+	 * @see Bitboard
+	 */
+	inline
+	const Bitboard&
+	plateau() const
 	{
-	    return komi_;
+	    return plateau_;
+	}
+
+	/**
+	 * \brief Images d'une intersection par les Symetrie::NB
+	 *        symétries du goban.
+	 *
+	 * L'intersection et ses images sont repérées par leur indice
+	 * avec bordure, comme dans plateau(). L'image par la symétrie
+	 * de code s est le s-ième élément du tableau retourné. Les
+	 * intersections de la bordure sont leurs propres images.
+	 */
+	inline
+	const int*
+	symetriques(int k) const
+	{
+	    return &symetriques_[Symetrie::NB * k];
 	}
 
     private:
 
+	/**
+	 * \brief Calcul de l'ensemble des intersections du goban,
+	 *        après vérification de la taille.
+	 */
+	void
+	initialiserPlateau();
+
+	/**
+	 * \brief Calcul des images des intersections par les
+	 *        symétries.
+	 */
+	void
+	initialiserSymetriques();
+
 	/**
 	 * \brief Taille du goban.
 	 */
 	int taille_;
 
 	/**
-	 * \brief Points donnés initialement au joueur blanc pour
+	 * \brief Demi-points donnés initialement au joueur blanc pour
 	 *        compenser le fait que le joueur noir commence.
 	 */
-	int komi_;
+	int demiKomi_;
 
 	/**
 	 * \brief Liste des intersections qui sont des hoshi.
@@ -113,6 +169,61 @@ namespace jeu {
 	 */
 	std::list<Intersection> hoshi_;
 
+	/**
+	 * \brief Ensemble des intersections du goban.
+	 */
+	Bitboard plateau_;
+
+	/**
+	 * \brief Images des intersections par les symétries.
+	 *
+	 * @see symetriques(int) const
+	 */
+	std::vector<int> symetriques_;
+
+    };
+
+    /**
+     * \brief Ensemble de gobans créés à la demande.
+     *
+     * Les gobans ne sont détruits qu'avec l'ensemble, car des états
+     * qui les désignent peuvent survivre à la partie qui les a
+     * demandés ; un goban déjà créé avec la même taille et le même
+     * komi est réutilisé. Plusieurs threads peuvent partager un
+     * ensemble.
+     */
+    class Gobans {
+
+    public:
+
+	Gobans();
+
+	/**
+	 * \brief Goban de taille et de komi donnés, créé s'il
+	 *        n'existe pas encore.
+	 *
+	 * Le komi est en demi-points.
+	 */
+	const Goban&
+	goban(int taille, int demiKomi = 0);
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	Gobans(const Gobans&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	Gobans&
+	operator=(const Gobans&);
+
+	std::list<Goban> gobans_;
+
+	std::mutex mutex_;
+
     };
 
 }
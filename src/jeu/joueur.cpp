@@ -13,13 +13,24 @@
 
 namespace jeu {
 
+    JoueurAleatoire::JoueurAleatoire()
+	: generateur_(rand())
+    {
+    }
+
+    JoueurAleatoire::JoueurAleatoire(uint64_t graine)
+	: generateur_(graine)
+    {
+    }
+
     void
     JoueurAleatoire::debutTour(bool noir, const EtatGoban& etat,
 			       const Coup& dernierCoup)
     {
-	(void) noir;
 	(void) dernierCoup;
 
+	noir_ = noir;
+	etat_ = etat;
 	tailleGoban_ = etat.goban().taille();
 	nbEssais_ = 0;
     }
@@ -28,14 +39,14 @@ namespace jeu {
     Coup
     JoueurAleatoire::jouer()
     {
+	// le coup tiré est toujours licite pour l'état du goban ; il
+	// ne peut être refusé que par le superko, d'où la limite
 	Coup coup;
 	if (++nbEssais_ == tailleGoban_ * tailleGoban_) {
 	    coup.type = TC_PASSER;
 	}
 	else {
-	    coup.type = TC_POSER;
-	    coup.intersection.i = rand() % tailleGoban_;
-	    coup.intersection.j = rand() % tailleGoban_;
+	    coup = etat_.coupAleatoire(noir_, generateur_, true);
 	}
 	return coup;
     }
@@ -106,11 +117,9 @@ namespace jeu {
     void
     JoueurTexte::afficherEtat(const EtatGoban& etat)
     {
-	static char symboles[NB_EI];
-	symboles[EI_NOIR] = 'x';
-	symboles[EI_BLANC] = 'o';
-	symboles[EI_VIDE] = '.';
-	symboles[EI_GRIS] = '+'; // utilisé pour les hoshi
+	// indexés par EI_NOIR, EI_BLANC, EI_VIDE et EI_GRIS, ce
+	// dernier étant utilisé pour les hoshi
+	static const char symboles[NB_EI] = {'x', 'o', '.', '+'};
 
 	Intersection inter;
 
@@ -193,4 +202,21 @@ namespace jeu {
 	return coup;
     }
 
+    void
+    Spectateur::debutTour(bool noir, const EtatGoban& etat,
+			  const Coup& dernierCoup)
+    {
+	(void) noir;
+	(void) etat;
+	(void) dernierCoup;
+    }
+
+    Coup
+    Spectateur::jouer()
+    {
+	Coup coup;
+	coup.type = TC_PASSER;
+	return coup;
+    }
+
 }
@@ -5,6 +5,8 @@
 
 #include <jeu/types.hpp> // jeu::Coup, jeu::TypeCoup
 #include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/generateur.hpp> // jeu::Generateur
+#include <jeu/pendule.hpp> // jeu::Pendule
 
 namespace jeu {
 
@@ -18,6 +20,15 @@ namespace jeu {
 
     public:
 
+	/**
+	 * \brief Destructeur virtuel, les joueurs pouvant être
+	 *        détruits par un pointeur sur cette classe.
+	 */
+	virtual
+	~Joueur()
+	{
+	}
+
 	/**
 	 * \brief Début d'un nouveau tour de jeu.
 	 */
@@ -35,6 +46,20 @@ namespace jeu {
 	jouer()
 	= 0;
 
+	/**
+	 * \brief Information du joueur sur le temps dont il dispose.
+	 *
+	 * La partie appelle cette fonction avant de demander un coup
+	 * au joueur, avec sa pendule qui vient d'être déclenchée. Par
+	 * défaut, les joueurs n'en tiennent pas compte.
+	 */
+	virtual
+	void
+	tempsRestant(const Pendule& pendule)
+	{
+	    (void) pendule;
+	}
+
 	/**
 	 * \brief Savoir si le joueur sait compter les points.
 	 *
@@ -124,12 +149,31 @@ namespace jeu {
     /**
      * \brief Joueur ordinateur jouant de façon totalement aléatoire.
      *
+     * Le joueur tire uniformément parmi les coups licites de l'état
+     * reçu en début de tour qui ne bouchent pas l'un de ses yeux.
+     * Il passe quand il n'y en a plus, ou quand trop de ses coups
+     * ont été refusés par la partie à cause du superko.
+     *
      * @see Joueur
      */
     class JoueurAleatoire : public Joueur {
 
     public:
 
+	/**
+	 * \brief Constructeur de joueur aléatoire.
+	 *
+	 * La graine du générateur est tirée avec rand(), afin de
+	 * suivre l'initialisation faite avec srand().
+	 */
+	JoueurAleatoire();
+
+	/**
+	 * \brief Constructeur de joueur aléatoire à graine donnée.
+	 */
+	explicit
+	JoueurAleatoire(uint64_t graine);
+
 	virtual
 	void
 	debutTour(bool noir, const EtatGoban& etat,
@@ -141,11 +185,43 @@ namespace jeu {
 
     private:
 
+	bool noir_;
+
+	EtatGoban etat_;
+
+	Generateur generateur_;
+
 	int tailleGoban_;
 	int nbEssais_;
 
     };
 
+    /**
+     * \brief Joueur qui ne choisit aucun coup, ceux de la partie
+     *        lui étant imposés.
+     *
+     * Il sert aux parties dont les coups sont donnés par
+     * Partie::jouer(), qui vérifie leur validité : relecture d'une
+     * partie enregistrée, mise en place d'une position. S'il doit
+     * tout de même jouer, il passe.
+     *
+     * @see Joueur
+     */
+    class Spectateur : public Joueur {
+
+    public:
+
+	virtual
+	void
+	debutTour(bool noir, const EtatGoban& etat,
+		  const Coup& dernierCoup);
+
+	virtual
+	Coup
+	jouer();
+
+    };
+
 }
 
 #endif
@@ -1,7 +1,6 @@
 #include <list>
 #include <iostream>
-#include <stack>
-#include <algorithm> // std::find
+#include <utility> // std::make_pair
 
 #include <jeu/types.hpp> // jeu::Intersection
 #include <jeu/goban.hpp> // jeu::Goban
@@ -20,9 +19,15 @@ namespace jeu {
 	  tourNoir_(true),
 	  finie_(false),
 	  etatFinal_(false),
-	  etats_()
+	  etat_(goban_),
+	  mouvements_(),
+	  prises_(),
+	  instantanes_(1, etat_),
+	  positions_(),
+	  dernierCoup_(),
+	  historique_()
     {
-	etats_.push_front(EtatGoban(goban_));
+	positions_.insert(std::make_pair(etat_.hash(), 0));
     }
 
     Partie::Partie(const EtatGoban& etat, bool tourNoir,
@@ -34,9 +39,15 @@ namespace jeu {
 	  tourNoir_(tourNoir),
 	  finie_(false),
 	  etatFinal_(false),
-	  etats_()
+	  etat_(etat),
+	  mouvements_(),
+	  prises_(),
+	  instantanes_(1, etat),
+	  positions_(),
+	  dernierCoup_(),
+	  historique_()
     {
-	etats_.push_front(etat);
+	positions_.insert(std::make_pair(etat_.hash(), 0));
     }
 
     void
@@ -52,15 +63,23 @@ namespace jeu {
 	}
     }
 
+    void
+    Partie::reglerPendules(const Pendule& pendule)
+    {
+	pendules_[0] = pendule;
+	pendules_[1] = pendule;
+    }
+
     void
     Partie::tourSuivant()
     {
 	if (!finie_) {
-	    // on signale le début du tour
-	    noir_.debutTour(tourNoir_, etatCourant(), dernierCoup_);
-	    blanc_.debutTour(tourNoir_, etatCourant(), dernierCoup_);
+	    annoncerTour();
 
 	    Joueur& joueur = tourNoir_ ? noir_ : blanc_;
+	    Pendule& pendule = pendules_[tourNoir_ ? 0 : 1];
+	    pendule.demarrer();
+	    joueur.tempsRestant(pendule);
 
 	    // on demande un coup au joueur jusqu'à avoir un coup valide
 	    Coup coup = joueur.jouer();
@@ -70,24 +89,102 @@ namespace jeu {
 		coup = joueur.jouer();
 	    }
 
-	    // détection d'une fin de partie
-	    if (coup.type == TC_PASSER &&
-		 dernierCoup_.type == TC_PASSER) {
-		// todo : vérifier que ce n'est pas noir qui passe deux
-		// fois au lieu de poser ses pierres de handicap
-
-		noir_.debutTour(tourNoir_, etatCourant(), coup);
-		blanc_.debutTour(tourNoir_, etatCourant(), coup);
+	    // un coup joué hors du temps n'est pas enregistré : la
+	    // pierre est retirée pour que l'état reste celui de
+	    // l'historique
+	    pendule.arreter();
+	    if (pendule.ecoulee()) {
+		if (coup.type == TC_POSER) {
+		    retour();
+		}
 		finie_ = true;
+		return;
 	    }
 
-	    else {
-		dernierCoup_ = coup;
-		tourNoir_ = !tourNoir_;
-	    }
+	    terminerTour(coup);
+	}
+    }
+
+    void
+    Partie::annoncerTour()
+    {
+	noir_.debutTour(tourNoir_, etatCourant(), dernierCoup_);
+	blanc_.debutTour(tourNoir_, etatCourant(), dernierCoup_);
+    }
+
+    bool
+    Partie::jouer(const Coup& coup)
+    {
+	if (finie_ || coup.type == TC_INVALIDE) {
+	    return false;
+	}
+	annoncerTour();
+	if (coup.type == TC_POSER && !poser(coup.intersection)) {
+	    return false;
+	}
+	terminerTour(coup);
+	return true;
+    }
+
+    void
+    Partie::terminerTour(const Coup& coup)
+    {
+	historique_.push_back(coup);
+
+	// détection d'une fin de partie
+	if (coup.type == TC_PASSER &&
+	     dernierCoup_.type == TC_PASSER) {
+	    // todo : vérifier que ce n'est pas noir qui passe deux
+	    // fois au lieu de poser ses pierres de handicap
+
+	    noir_.debutTour(tourNoir_, etatCourant(), coup);
+	    blanc_.debutTour(tourNoir_, etatCourant(), coup);
+	    finie_ = true;
+	}
+
+	else {
+	    dernierCoup_ = coup;
+	    tourNoir_ = !tourNoir_;
 	}
     }
 
+    bool
+    Partie::annuler()
+    {
+	if (historique_.empty() || etatFinal_) {
+	    return false;
+	}
+
+	Coup coup = historique_.back();
+	historique_.pop_back();
+	if (coup.type == TC_POSER) {
+	    retour();
+	}
+
+	// le dernier passe d'une partie finie n'a pas changé le trait
+	if (finie_) {
+	    finie_ = false;
+	}
+	else {
+	    tourNoir_ = !tourNoir_;
+	}
+	dernierCoup_ = historique_.empty() ? Coup() : historique_.back();
+	return true;
+    }
+
+    bool
+    Partie::reprendre()
+    {
+	if (!finie_ || etatFinal_ || perdueAuTemps() ||
+	    historique_.empty() || historique_.back().type != TC_PASSER) {
+	    return false;
+	}
+	finie_ = false;
+	dernierCoup_ = historique_.back();
+	tourNoir_ = !tourNoir_;
+	return true;
+    }
+
     bool
     Partie::fin()
     {
@@ -145,52 +242,74 @@ namespace jeu {
     bool
     Partie::poser(const Intersection& inter)
     {
-	// on ajoute une copie du dernier état en début de liste
-	// et on travaille sur celle-ci
-	etats_.push_front(etats_.front());
-	EtatGoban& etatCourant = etats_.front();
-
-	if (!etatCourant.poser(inter, tourNoir_)) {
-	    etats_.pop_front();
+	// le coup est joué directement sur l'état courant et
+	// enregistré pour pouvoir être annulé
+	Mouvement mouvement;
+	if (!etat_.poser(inter, tourNoir_, mouvement, prises_)) {
 	    return false;
 	}
+	mouvements_.push_back(mouvement);
 
-	/*
-	// est-ce un ko simple ?
-	std::list<EtatGoban>::const_iterator etatAnterieur = etats_.begin();
-	if (++etatAnterieur != etats_.end()) {
-	    if (++etatAnterieur != etats_.end()) {
-		if (*etatAnterieur == etatCourant) {
-		    etats_.pop_front();
-		    return false;
-		}
+	// superko positionnel : une position de l'historique n'est
+	// reconstituée que si son hachage est celui du nouvel état
+	typedef std::unordered_multimap<uint64_t, int>::const_iterator It;
+	std::pair<It, It> memes = positions_.equal_range(etat_.hash());
+	for (It it = memes.first; it != memes.second; ++it) {
+	    if (etatApres(it->second) == etat_) {
+		retour();
+		return false;
 	    }
 	}
-	*/
 
-	// gestion simple (mais potentiellement lourde) des kos
-	// compliqués
-	if (etats_.end() != std::find(++(etats_.begin()), etats_.end(),
-				      etatCourant)) {
-	    etats_.pop_front();
-	    return false;
+	positions_.insert(std::make_pair(etat_.hash(), nbCoups()));
+	if (nbCoups() % INTERVALLE_INSTANTANES == 0) {
+	    instantanes_.push_back(etat_);
 	}
-
 	return true;
     }
 
+    EtatGoban
+    Partie::etatApres(int nbCoups) const
+    {
+	int instantane = nbCoups / INTERVALLE_INSTANTANES;
+	EtatGoban etat(instantanes_[instantane]);
+	for (int n = instantane * INTERVALLE_INSTANTANES; n < nbCoups; ++n) {
+	    etat.poser(mouvements_[n].intersection, mouvements_[n].noir);
+	}
+	return etat;
+    }
+
     void
     Partie::afficher(std::ostream& out) const
     {
-	std::list<EtatGoban>::const_iterator it;
-	for (it = etats_.begin(); it != etats_.end(); ++it) {
-	    out << *it << std::endl;
+	for (int n = nbCoups(); n >= 0; --n) {
+	    out << etatApres(n) << std::endl;
 	}
     }
 
     void
     Partie::retour()
     {
-	etats_.pop_front();
+	if (mouvements_.empty()) {
+	    return;
+	}
+
+	// retrait de la position courante de l'historique
+	typedef std::unordered_multimap<uint64_t, int>::iterator It;
+	std::pair<It, It> memes = positions_.equal_range(etat_.hash());
+	for (It it = memes.first; it != memes.second; ++it) {
+	    if (it->second == nbCoups()) {
+		positions_.erase(it);
+		break;
+	    }
+	}
+
+	if ((int) instantanes_.size() > nbCoups() / INTERVALLE_INSTANTANES
+	    && nbCoups() % INTERVALLE_INSTANTANES == 0) {
+	    instantanes_.pop_back();
+	}
+
+	etat_.annuler(mouvements_.back(), prises_);
+	mouvements_.pop_back();
     }
 }
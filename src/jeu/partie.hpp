@@ -1,13 +1,16 @@
 #ifndef JEU_PARTIE_HPP
 #define JEU_PARTIE_HPP
 
-#include <list> // std::list
+#include <vector> // std::vector
 #include <ostream> // std::ostream
+#include <unordered_map> // std::unordered_multimap
+#include <stdint.h> // uint64_t
 
 #include <jeu/types.hpp> // jeu::Intersection
 #include <jeu/goban.hpp> // jeu::Goban
 #include <jeu/etatgoban.hpp> // jeu::EtatGoban
 #include <jeu/joueur.hpp> // jeu::Joueur
+#include <jeu/pendule.hpp> // jeu::Pendule
 
 namespace jeu {
 
@@ -51,12 +54,77 @@ namespace jeu {
 	void
 	debut();
 
+	/**
+	 * \brief Réglage des pendules des deux joueurs.
+	 *
+	 * Par défaut, les pendules sont illimitées.
+	 */
+	void
+	reglerPendules(const Pendule& pendule);
+
+	/**
+	 * \brief Accès à la pendule d'un joueur.
+	 */
+	inline
+	const Pendule&
+	pendule(bool noir) const
+	{
+	    return pendules_[noir ? 0 : 1];
+	}
+
 	/**
 	 * \brief Faire jouer le prochain joueur.
+	 *
+	 * La pendule du joueur tourne pendant qu'il choisit son coup.
+	 * S'il dépasse son temps, la partie est finie et il l'a
+	 * perdue ; le coup qu'il a choisi n'est pas joué.
 	 */
 	void
 	tourSuivant();
 
+	/**
+	 * \brief Signal du début du tour aux deux joueurs.
+	 *
+	 * tourSuivant() et jouer(const Coup&) le font d'elles-mêmes ;
+	 * l'appeler dès la fin du tour précédent permet aux joueurs de
+	 * réfléchir pendant que l'adversaire choisit son coup.
+	 */
+	void
+	annoncerTour();
+
+	/**
+	 * \brief Jouer un coup donné pour le joueur qui a le trait,
+	 *        sans le lui demander.
+	 *
+	 * Les joueurs sont informés du début du tour comme avec
+	 * tourSuivant(). La valeur de retour indique si le coup était
+	 * licite ; s'il ne l'était pas, la partie est inchangée.
+	 */
+	bool
+	jouer(const Coup& coup);
+
+	/**
+	 * \brief Annulation du dernier coup, pierre posée ou passe.
+	 *
+	 * Le trait revient au joueur qui avait joué ce coup. La
+	 * valeur de retour indique si un coup a été annulé, ce qui
+	 * n'est pas possible une fois les points comptés.
+	 */
+	bool
+	annuler();
+
+	/**
+	 * \brief Reprise d'une partie finie par deux passes, avant que
+	 *        les points ne soient comptés.
+	 *
+	 * Le dernier passe devient un coup ordinaire : le trait passe
+	 * à l'adversaire, et un nouveau passe finirait de nouveau la
+	 * partie. La valeur de retour indique si la partie a été
+	 * reprise ; elle ne peut pas l'être après une perte au temps.
+	 */
+	bool
+	reprendre();
+
 	/**
 	 * \brief Faire compter les points aux joueurs.
 	 *
@@ -69,6 +137,9 @@ namespace jeu {
 
 	/**
 	 * \brief Retour en arrière d'un tour.
+	 *
+	 * Le dernier coup enregistré est annulé sur l'état courant,
+	 * sans recopie de goban.
 	 */
 	void
 	retour();
@@ -80,7 +151,7 @@ namespace jeu {
 	EtatGoban&
 	etatCourant()
 	{
-	    return etats_.front();
+	    return etat_;
 	}
 
 	/**
@@ -91,7 +162,19 @@ namespace jeu {
 	const EtatGoban&
 	etatCourant() const
 	{
-	    return etats_.front();
+	    return etat_;
+	}
+
+	/**
+	 * \brief Savoir si la partie a été perdue au temps, auquel
+	 *        cas le perdant est le joueur dont la pendule est
+	 *        écoulée.
+	 */
+	inline
+	bool
+	perdueAuTemps() const
+	{
+	    return pendules_[0].ecoulee() || pendules_[1].ecoulee();
 	}
 
 	/**
@@ -109,6 +192,27 @@ namespace jeu {
 	    return finie_;
 	}
 
+	/**
+	 * \brief Savoir si c'est à noir de jouer.
+	 */
+	inline
+	bool
+	tourNoir() const
+	{
+	    return tourNoir_;
+	}
+
+	/**
+	 * \brief Coups joués depuis le début de la partie, passes
+	 *        comprises, dans l'ordre.
+	 */
+	inline
+	const std::vector<Coup>&
+	historique() const
+	{
+	    return historique_;
+	}
+
 	/**
 	 * \brief Accès au dernier coup joué dans la partie.
 	 */
@@ -119,6 +223,26 @@ namespace jeu {
 	    return dernierCoup_;
 	}
 
+	/**
+	 * \brief Nombre de pierres posées depuis le début de la partie.
+	 */
+	inline
+	int
+	nbCoups() const
+	{
+	    return mouvements_.size();
+	}
+
+	/**
+	 * \brief Reconstitution de l'état du goban après un nombre
+	 *        donné de pierres posées.
+	 *
+	 * L'état est reconstruit à partir de l'instantané le plus
+	 * proche en rejouant les coups suivants.
+	 */
+	EtatGoban
+	etatApres(int nbCoups) const;
+
 	/**
 	 * \brief Affichage de la partie sur un flux de sortie pour
 	 *        debug.
@@ -128,6 +252,11 @@ namespace jeu {
 
     private:
 
+	/**
+	 * \brief Nombre de coups entre deux instantanés du goban.
+	 */
+	static const int INTERVALLE_INSTANTANES = 32;
+
 	/** \brief Pose d'une pierre
 	 *
 	 * 
@@ -135,6 +264,13 @@ namespace jeu {
 	bool
 	poser(const Intersection& inter);
 
+	/**
+	 * \brief Enregistrement d'un coup valide et passage au tour
+	 *        suivant, ou fin de la partie après deux passes.
+	 */
+	void
+	terminerTour(const Coup& coup);
+
 	/** \brief
 	 */
 	const Goban& goban_;
@@ -148,9 +284,50 @@ namespace jeu {
 	bool finie_;
 	bool etatFinal_;
 
-	std::list<EtatGoban> etats_;
+	/**
+	 * \brief État courant du goban.
+	 */
+	EtatGoban etat_;
+
+	/**
+	 * \brief Historique des pierres posées, permettant de les
+	 *        annuler.
+	 */
+	std::vector<Mouvement> mouvements_;
+
+	/**
+	 * \brief Pile des pierres capturées au cours de la partie.
+	 *
+	 * @see Mouvement
+	 */
+	std::vector<int> prises_;
+
+	/**
+	 * \brief États du goban tous les INTERVALLE_INSTANTANES
+	 *        coups, à partir de l'état initial.
+	 */
+	std::vector<EtatGoban> instantanes_;
+
+	/**
+	 * \brief Nombre de coups après lequel chaque position de
+	 *        l'historique est apparue, indexé par son hachage.
+	 *
+	 * Il permet de ne reconstituer une position de l'historique
+	 * qu'en cas de collision.
+	 */
+	std::unordered_multimap<uint64_t, int> positions_;
 
 	Coup dernierCoup_;
+
+	/**
+	 * \brief Coups joués, passes comprises.
+	 */
+	std::vector<Coup> historique_;
+
+	/**
+	 * \brief Pendules de noir et de blanc.
+	 */
+	Pendule pendules_[2];
     };
 
 
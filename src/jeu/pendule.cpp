@@ -0,0 +1,75 @@
+#include <chrono>
+
+#include <jeu/pendule.hpp>
+
+namespace jeu {
+
+    Pendule::Pendule()
+	: illimitee_(true),
+	  ecoulee_(false),
+	  tempsPrincipal_(0),
+	  dureePeriode_(0),
+	  nbPeriodes_(0),
+	  debut_(std::chrono::steady_clock::now())
+    {
+    }
+
+    Pendule::Pendule(double tempsPrincipal, double dureePeriode,
+		     int nbPeriodes)
+	: illimitee_(false),
+	  ecoulee_(false),
+	  tempsPrincipal_(tempsPrincipal),
+	  dureePeriode_(dureePeriode),
+	  nbPeriodes_(dureePeriode > 0 ? nbPeriodes : 0),
+	  debut_(std::chrono::steady_clock::now())
+    {
+    }
+
+    void
+    Pendule::demarrer()
+    {
+	debut_ = std::chrono::steady_clock::now();
+    }
+
+    void
+    Pendule::arreter()
+    {
+	if (illimitee_ || ecoulee_) {
+	    return;
+	}
+
+	double ecoule = tempsEcoule();
+
+	// le temps principal est consommé en premier
+	if (ecoule <= tempsPrincipal_) {
+	    tempsPrincipal_ -= ecoule;
+	    return;
+	}
+	ecoule -= tempsPrincipal_;
+	tempsPrincipal_ = 0;
+
+	// puis une période est perdue pour chaque période dépassée
+	while (nbPeriodes_ > 0 && ecoule > dureePeriode_) {
+	    ecoule -= dureePeriode_;
+	    --nbPeriodes_;
+	}
+	if (nbPeriodes_ == 0) {
+	    ecoulee_ = true;
+	}
+    }
+
+    double
+    Pendule::tempsCoup() const
+    {
+	return tempsPrincipal_ + nbPeriodes_ * dureePeriode_;
+    }
+
+    double
+    Pendule::tempsEcoule() const
+    {
+	std::chrono::duration<double> duree =
+	    std::chrono::steady_clock::now() - debut_;
+	return duree.count();
+    }
+
+}
@@ -0,0 +1,138 @@
+#ifndef JEU_PENDULE_HPP
+#define JEU_PENDULE_HPP
+
+#include <chrono> // std::chrono::steady_clock
+
+namespace jeu {
+
+    /**
+     * \brief Classe représentant la pendule d'un joueur.
+     *
+     * La cadence est celle du byo-yomi japonais : le joueur
+     * dispose d'abord d'un temps principal pour l'ensemble de ses
+     * coups, puis d'un nombre de périodes de durée fixe. Une fois
+     * le temps principal écoulé, un coup joué en moins d'une
+     * période ne coûte rien ; chaque période entièrement dépassée
+     * est perdue, et le dépassement de la dernière fait perdre la
+     * partie au temps.
+     *
+     * Les durées sont exprimées en secondes. Une pendule construite
+     * sans paramètres est illimitée.
+     */
+    class Pendule {
+
+    public:
+
+	/**
+	 * \brief Constructeur de pendule illimitée.
+	 */
+	Pendule();
+
+	/**
+	 * \brief Constructeur de pendule à partir d'une cadence.
+	 *
+	 * Sans périodes de byo-yomi, la partie est perdue dès que le
+	 * temps principal est écoulé.
+	 */
+	Pendule(double tempsPrincipal, double dureePeriode = 0,
+		int nbPeriodes = 0);
+
+	/**
+	 * \brief Déclenchement de la pendule au début d'un coup.
+	 */
+	void
+	demarrer();
+
+	/**
+	 * \brief Arrêt de la pendule à la fin d'un coup.
+	 *
+	 * Le temps écoulé depuis le déclenchement est décompté.
+	 */
+	void
+	arreter();
+
+	/**
+	 * \brief Savoir si la pendule est illimitée.
+	 */
+	inline
+	bool
+	illimitee() const
+	{
+	    return illimitee_;
+	}
+
+	/**
+	 * \brief Savoir si le joueur a dépassé son temps.
+	 */
+	inline
+	bool
+	ecoulee() const
+	{
+	    return ecoulee_;
+	}
+
+	/**
+	 * \brief Temps principal restant.
+	 */
+	inline
+	double
+	tempsPrincipal() const
+	{
+	    return tempsPrincipal_;
+	}
+
+	/**
+	 * \brief Durée d'une période de byo-yomi.
+	 */
+	inline
+	double
+	dureePeriode() const
+	{
+	    return dureePeriode_;
+	}
+
+	/**
+	 * \brief Nombre de périodes de byo-yomi restantes.
+	 */
+	inline
+	int
+	nbPeriodes() const
+	{
+	    return nbPeriodes_;
+	}
+
+	/**
+	 * \brief Temps dont dispose le joueur pour le coup en cours
+	 *        avant de perdre au temps, mesuré au déclenchement.
+	 */
+	double
+	tempsCoup() const;
+
+	/**
+	 * \brief Temps écoulé depuis le déclenchement de la pendule.
+	 */
+	double
+	tempsEcoule() const;
+
+    private:
+
+	bool illimitee_;
+
+	bool ecoulee_;
+
+	double tempsPrincipal_;
+
+	double dureePeriode_;
+
+	int nbPeriodes_;
+
+	/**
+	 * \brief Instant du déclenchement.
+	 */
+	std::chrono::steady_clock::time_point debut_;
+
+    };
+
+}
+
+#endif
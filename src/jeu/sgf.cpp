@@ -0,0 +1,496 @@
+#include <cctype> // std::isspace, std::isalpha, std::isupper
+#include <cstdlib> // std::strtol, std::atof, std::atoi
+
+#include <algorithm> // std::min, std::max
+
+#include <jeu/types.hpp> // jeu::Intersection, jeu::Coup
+#include <jeu/bitboard.hpp> // jeu::Bitboard
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/partie.hpp> // jeu::Partie
+
+#include <jeu/sgf.hpp>
+
+namespace jeu {
+
+    namespace {
+
+	const std::streambuf::int_type FIN = std::streambuf::traits_type::eof();
+
+	/**
+	 * \brief Propriétés dont la valeur est retenue, les autres
+	 *        étant sautées sans être recopiées.
+	 */
+	const char* const PROPRIETES[] = {
+	    "SZ", "KM", "HA", "AB", "AW", "B", "W", "PL", "PB", "PW", "RE"
+	};
+
+	const int NB_PROPRIETES = sizeof(PROPRIETES) / sizeof(*PROPRIETES);
+
+	bool
+	retenue(const std::string& identifiant)
+	{
+	    for (int p = 0; p < NB_PROPRIETES; ++p) {
+		if (identifiant == PROPRIETES[p]) {
+		    return true;
+		}
+	    }
+	    return false;
+	}
+
+    }
+
+    PartieSgf::PartieSgf()
+	: taille(19),
+	  komi(0),
+	  handicap(0),
+	  noires(),
+	  blanches(),
+	  premierNoir(true),
+	  coups(),
+	  joueurNoir(),
+	  joueurBlanc(),
+	  resultat()
+    {
+    }
+
+    void
+    PartieSgf::vider()
+    {
+	taille = 19;
+	komi = 0;
+	handicap = 0;
+	noires.clear();
+	blanches.clear();
+	premierNoir = true;
+	coups.clear();
+	joueurNoir.clear();
+	joueurBlanc.clear();
+	resultat.clear();
+    }
+
+    bool
+    PartieSgf::placer(EtatGoban& etat) const
+    {
+	if (etat.goban().taille() != taille) {
+	    return false;
+	}
+	for (unsigned int n = 0; n < noires.size(); ++n) {
+	    if (!etat.poser(noires[n], true)) {
+		return false;
+	    }
+	}
+	for (unsigned int n = 0; n < blanches.size(); ++n) {
+	    if (!etat.poser(blanches[n], false)) {
+		return false;
+	    }
+	}
+	return true;
+    }
+
+    bool
+    PartieSgf::rejouer(Partie& partie) const
+    {
+	for (unsigned int n = 0; n < coups.size(); ++n) {
+	    if (!partie.jouer(coups[n])) {
+		return false;
+	    }
+	}
+	return true;
+    }
+
+    LecteurSgf::LecteurSgf(std::istream& in)
+	: tampon_(in.rdbuf()),
+	  termine_(tampon_ == NULL),
+	  erreur_(),
+	  nbParties_(0),
+	  identifiant_(),
+	  valeur_(),
+	  traitConnu_(false),
+	  tourNoir_(true)
+    {
+    }
+
+    bool
+    LecteurSgf::suivante(PartieSgf& partie)
+    {
+	partie.vider();
+	erreur_.clear();
+	traitConnu_ = false;
+	tourNoir_ = true;
+	if (termine_) {
+	    return false;
+	}
+
+	// ce qui précède la première parenthèse est ignoré
+	std::streambuf::int_type c = tampon_->sbumpc();
+	while (c != FIN && c != '(') {
+	    c = tampon_->sbumpc();
+	}
+	if (c == FIN) {
+	    termine_ = true;
+	    return false;
+	}
+	++nbParties_;
+
+	// la ligne principale suit la première variante de chaque
+	// nœud : elle se termine à la première parenthèse fermante,
+	// après quoi le reste de l'arbre est seulement parcouru
+	int profondeur = 1;
+	bool principale = true;
+	while (profondeur > 0) {
+	    c = tampon_->sbumpc();
+	    if (c == FIN) {
+		termine_ = true;
+		if (erreur_.empty()) {
+		    erreur_ = "fin du flux au milieu d'une partie";
+		}
+		return false;
+	    }
+	    if (std::isspace(c) || c == ';') {
+		continue;
+	    }
+	    if (c == '(') {
+		++profondeur;
+	    }
+	    else if (c == ')') {
+		--profondeur;
+		principale = false;
+	    }
+	    else if (std::isalpha(c)) {
+		// les minuscules des anciennes versions sont ignorées
+		identifiant_.clear();
+		for (;;) {
+		    if (std::isupper(c)) {
+			identifiant_ += (char) c;
+		    }
+		    c = tampon_->sgetc();
+		    if (c == FIN || !std::isalpha(c)) {
+			break;
+		    }
+		    tampon_->sbumpc();
+		}
+
+		bool garder = principale && erreur_.empty()
+		    && retenue(identifiant_);
+		int nbValeurs = 0;
+		for (;;) {
+		    while ((c = tampon_->sgetc()) != FIN && std::isspace(c)) {
+			tampon_->sbumpc();
+		    }
+		    if (c != '[') {
+			break;
+		    }
+		    tampon_->sbumpc();
+		    if (!lireValeur(garder)) {
+			termine_ = true;
+			erreur_ = "fin du flux dans une valeur";
+			return false;
+		    }
+		    ++nbValeurs;
+		    if (garder && !propriete(partie)) {
+			garder = false;
+		    }
+		}
+		if (nbValeurs == 0 && erreur_.empty()) {
+		    erreur_ = "propriété " + identifiant_ + " sans valeur";
+		}
+	    }
+	    else if (erreur_.empty()) {
+		erreur_ = "caractère inattendu";
+	    }
+	}
+
+	if (!erreur_.empty()) {
+	    return false;
+	}
+
+	// sans coup ni PL, blanc commence après des pierres de
+	// handicap
+	if (!traitConnu_) {
+	    partie.premierNoir = partie.handicap < 2 &&
+		(partie.noires.empty() || !partie.blanches.empty());
+	}
+	return true;
+    }
+
+    bool
+    LecteurSgf::lireValeur(bool garder)
+    {
+	valeur_.clear();
+	for (;;) {
+	    std::streambuf::int_type c = tampon_->sbumpc();
+	    if (c == FIN) {
+		return false;
+	    }
+	    if (c == ']') {
+		return true;
+	    }
+	    if (c == '\\') {
+		c = tampon_->sbumpc();
+		if (c == FIN) {
+		    return false;
+		}
+		// un saut de ligne protégé est supprimé
+		if (c == '\r' && tampon_->sgetc() == '\n') {
+		    tampon_->sbumpc();
+		}
+		if (c == '\r' || c == '\n') {
+		    continue;
+		}
+	    }
+	    if (garder) {
+		valeur_ += (char) c;
+	    }
+	}
+    }
+
+    bool
+    LecteurSgf::propriete(PartieSgf& partie)
+    {
+	const std::string& id = identifiant_;
+	bool debut = partie.coups.empty();
+
+	if (id == "SZ") {
+	    char* fin;
+	    long taille = std::strtol(valeur_.c_str(), &fin, 10);
+	    if (*fin != '\0' || taille < 2 || taille > Bitboard::TAILLE_MAX) {
+		erreur_ = "taille non gérée : " + valeur_;
+		return false;
+	    }
+	    if (!debut || !partie.noires.empty() || !partie.blanches.empty()) {
+		erreur_ = "taille donnée après les premières pierres";
+		return false;
+	    }
+	    partie.taille = taille;
+	}
+	else if (id == "KM") {
+	    partie.komi = std::atof(valeur_.c_str());
+	}
+	else if (id == "HA") {
+	    partie.handicap = std::atoi(valeur_.c_str());
+	}
+	else if (id == "AB" || id == "AW") {
+	    if (!debut) {
+		erreur_ = "pierres placées en cours de partie";
+		return false;
+	    }
+	    // une intersection ou un rectangle de la forme aa:cc
+	    Intersection coin1;
+	    Intersection coin2;
+	    if (!(valeur_.size() == 2 &&
+		  lirePoint(valeur_.c_str(), partie.taille, coin1) &&
+		  lirePoint(valeur_.c_str(), partie.taille, coin2)) &&
+		!(valeur_.size() == 5 && valeur_[2] == ':' &&
+		  lirePoint(valeur_.c_str(), partie.taille, coin1) &&
+		  lirePoint(valeur_.c_str() + 3, partie.taille, coin2))) {
+		erreur_ = "intersection invalide : " + valeur_;
+		return false;
+	    }
+	    std::vector<Intersection>& pierres =
+		id == "AB" ? partie.noires : partie.blanches;
+	    Intersection inter;
+	    for (inter.i = std::min(coin1.i, coin2.i);
+		 inter.i <= std::max(coin1.i, coin2.i); ++inter.i) {
+		for (inter.j = std::min(coin1.j, coin2.j);
+		     inter.j <= std::max(coin1.j, coin2.j); ++inter.j) {
+		    pierres.push_back(inter);
+		}
+	    }
+	}
+	else if (id == "B" || id == "W") {
+	    bool noir = id == "B";
+	    Coup coup;
+	    if (valeur_.empty() ||
+		(valeur_ == "tt" && partie.taille <= 19)) {
+		coup.type = TC_PASSER;
+	    }
+	    else if (valeur_.size() != 2 ||
+		     !lirePoint(valeur_.c_str(), partie.taille,
+				coup.intersection)) {
+		erreur_ = "coup invalide : " + valeur_;
+		return false;
+	    }
+	    else {
+		coup.type = TC_POSER;
+	    }
+
+	    if (!traitConnu_) {
+		partie.premierNoir = noir;
+		tourNoir_ = noir;
+		traitConnu_ = true;
+	    }
+	    // une couleur qui joue deux fois fait passer l'autre
+	    if (noir != tourNoir_) {
+		Coup passe;
+		passe.type = TC_PASSER;
+		partie.coups.push_back(passe);
+	    }
+	    partie.coups.push_back(coup);
+	    tourNoir_ = !noir;
+	}
+	else if (id == "PL") {
+	    if (debut && (valeur_ == "B" || valeur_ == "W")) {
+		partie.premierNoir = valeur_ == "B";
+		tourNoir_ = partie.premierNoir;
+		traitConnu_ = true;
+	    }
+	}
+	else if (id == "PB") {
+	    partie.joueurNoir = valeur_;
+	}
+	else if (id == "PW") {
+	    partie.joueurBlanc = valeur_;
+	}
+	else if (id == "RE") {
+	    partie.resultat = valeur_;
+	}
+	return true;
+    }
+
+    bool
+    LecteurSgf::lirePoint(const char* texte, int taille, Intersection& inter)
+    {
+	int colonne = texte[0] - 'a';
+	int ligne = texte[1] - 'a';
+	if (colonne < 0 || colonne >= taille || ligne < 0 || ligne >= taille) {
+	    return false;
+	}
+	inter = Intersection(taille - 1 - ligne, colonne);
+	return true;
+    }
+
+    EcrivainSgf::EcrivainSgf(std::ostream& out)
+	: out_(out),
+	  taille_(19),
+	  ouverte_(false)
+    {
+    }
+
+    void
+    EcrivainSgf::debut(int taille, double komi,
+		       const std::string& joueurNoir,
+		       const std::string& joueurBlanc,
+		       const std::string& resultat)
+    {
+	fin();
+	taille_ = taille;
+	ouverte_ = true;
+	out_ << "(;GM[1]FF[4]CA[UTF-8]AP[knittuk]SZ[" << taille
+	     << "]KM[" << komi << "]";
+	if (!joueurNoir.empty()) {
+	    out_ << "PB[";
+	    texte(joueurNoir);
+	    out_ << "]";
+	}
+	if (!joueurBlanc.empty()) {
+	    out_ << "PW[";
+	    texte(joueurBlanc);
+	    out_ << "]";
+	}
+	if (!resultat.empty()) {
+	    out_ << "RE[";
+	    texte(resultat);
+	    out_ << "]";
+	}
+	out_.flush();
+    }
+
+    void
+    EcrivainSgf::placer(const Intersection& inter, bool noir)
+    {
+	out_ << (noir ? "AB[" : "AW[");
+	point(inter);
+	out_ << "]";
+    }
+
+    void
+    EcrivainSgf::coup(const Coup& coup, bool noir)
+    {
+	out_ << (noir ? ";B[" : ";W[");
+	if (coup.type == TC_POSER) {
+	    point(coup.intersection);
+	}
+	out_ << "]";
+	out_.flush();
+    }
+
+    void
+    EcrivainSgf::fin()
+    {
+	if (ouverte_) {
+	    out_ << ")\n";
+	    out_.flush();
+	    ouverte_ = false;
+	}
+    }
+
+    void
+    EcrivainSgf::ecrire(const Partie& partie, double komi,
+			const std::string& resultat)
+    {
+	EtatGoban depart = partie.etatApres(0);
+	int taille = depart.goban().taille();
+	debut(taille, komi, "", "", resultat);
+	Intersection inter;
+	for (inter.i = 0; inter.i < taille; ++inter.i) {
+	    for (inter.j = 0; inter.j < taille; ++inter.j) {
+		if (depart.etat(inter) == EI_NOIR ||
+		    depart.etat(inter) == EI_BLANC) {
+		    placer(inter, depart.etat(inter) == EI_NOIR);
+		}
+	    }
+	}
+
+	// la couleur d'une pierre est lue sur le goban après sa pose,
+	// celle d'un passe se déduit des coups voisins
+	const std::vector<Coup>& coups = partie.historique();
+	unsigned int premiere = 0;
+	while (premiere < coups.size() && coups[premiere].type != TC_POSER) {
+	    ++premiere;
+	}
+	bool noir;
+	if (premiere < coups.size()) {
+	    noir = partie.etatApres(1).etat(coups[premiere].intersection)
+		== EI_NOIR;
+	    noir = premiere % 2 == 0 ? noir : !noir;
+	}
+	else {
+	    // le dernier passe d'une partie finie n'a pas changé le
+	    // trait
+	    unsigned int nbAlternances = coups.size()
+		- (partie.finie() && !coups.empty() ? 1 : 0);
+	    noir = nbAlternances % 2 == 0
+		? partie.tourNoir() : !partie.tourNoir();
+	}
+
+	int nbPierres = 0;
+	for (unsigned int n = 0; n < coups.size(); ++n) {
+	    if (coups[n].type == TC_POSER) {
+		++nbPierres;
+		noir = partie.etatApres(nbPierres).etat(coups[n].intersection)
+		    == EI_NOIR;
+	    }
+	    coup(coups[n], noir);
+	    noir = !noir;
+	}
+	fin();
+    }
+
+    void
+    EcrivainSgf::point(const Intersection& inter)
+    {
+	out_ << (char) ('a' + inter.j) << (char) ('a' + taille_ - 1 - inter.i);
+    }
+
+    void
+    EcrivainSgf::texte(const std::string& texte)
+    {
+	for (std::string::size_type n = 0; n < texte.size(); ++n) {
+	    if (texte[n] == ']' || texte[n] == '\\') {
+		out_ << '\\';
+	    }
+	    out_ << texte[n];
+	}
+    }
+
+}
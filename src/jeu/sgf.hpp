@@ -0,0 +1,326 @@
+#ifndef JEU_SGF_HPP
+#define JEU_SGF_HPP
+
+#include <istream> // std::istream, std::streambuf
+#include <ostream> // std::ostream
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <jeu/types.hpp> // jeu::Intersection, jeu::Coup
+#include <jeu/goban.hpp> // jeu::Goban
+#include <jeu/etatgoban.hpp> // jeu::EtatGoban
+#include <jeu/partie.hpp> // jeu::Partie
+
+namespace jeu {
+
+    /**
+     * \brief Partie lue dans un fichier SGF.
+     *
+     * Seule la ligne principale de l'arbre de jeu est retenue. Les
+     * pierres placées avant le premier coup forment la position de
+     * départ ; les coups suivants alternent à partir du joueur qui
+     * a le trait au départ, un passe étant inséré lorsqu'une
+     * couleur joue deux fois de suite.
+     */
+    struct PartieSgf {
+
+	int taille;
+
+	/**
+	 * \brief Komi, éventuellement avec un demi-point.
+	 */
+	double komi;
+
+	int handicap;
+
+	/**
+	 * \brief Pierres noires et blanches placées au départ.
+	 */
+	std::vector<Intersection> noires;
+	std::vector<Intersection> blanches;
+
+	/**
+	 * \brief Savoir si noir a le trait au départ.
+	 */
+	bool premierNoir;
+
+	/**
+	 * \brief Coups de la ligne principale, passes comprises.
+	 */
+	std::vector<Coup> coups;
+
+	std::string joueurNoir;
+	std::string joueurBlanc;
+	std::string resultat;
+
+	PartieSgf();
+
+	/**
+	 * \brief Remise à zéro, en conservant la mémoire déjà
+	 *        allouée.
+	 */
+	void
+	vider();
+
+	/**
+	 * \brief Placement des pierres de départ sur un état du goban
+	 *        vide de la même taille.
+	 *
+	 * La valeur de retour indique si toutes les pierres ont pu
+	 * être placées.
+	 */
+	bool
+	placer(EtatGoban& etat) const;
+
+	/**
+	 * \brief Jeu des coups dans une partie commencée à partir de
+	 *        la position de départ.
+	 *
+	 * La partie doit avoir été construite à partir de l'état
+	 * rempli par placer() et de premierNoir, sans appel à
+	 * Partie::debut(). La valeur de retour indique si tous les
+	 * coups étaient licites ; les coups sont joués jusqu'au
+	 * premier qui ne l'est pas.
+	 */
+	bool
+	rejouer(Partie& partie) const;
+
+    };
+
+    /**
+     * \brief Lecture d'une collection de parties au format SGF.
+     *
+     * Les parties sont lues une à une au fil du flux, qui n'est
+     * jamais chargé en entier. Les valeurs des propriétés qui ne
+     * sont pas retenues ne sont pas recopiées, et la partie passée
+     * en paramètre garde sa mémoire d'une lecture à l'autre, si
+     * bien que la lecture d'une collection n'alloue presque plus
+     * rien après les premières parties.
+     *
+     * Une partie mal formée est sautée jusqu'à sa parenthèse
+     * fermante, et la lecture peut reprendre à la suivante.
+     */
+    class LecteurSgf {
+
+    public:
+
+	/**
+	 * \brief Constructeur de lecteur sur un flux d'entrée.
+	 */
+	explicit
+	LecteurSgf(std::istream& in);
+
+	/**
+	 * \brief Lecture de la partie suivante de la collection.
+	 *
+	 * La valeur de retour indique si une partie a été lue. Si ce
+	 * n'est pas le cas, soit le flux est terminé, soit la
+	 * partie était mal formée et erreur() en donne la raison ;
+	 * un nouvel appel passe alors à la partie suivante.
+	 */
+	bool
+	suivante(PartieSgf& partie);
+
+	/**
+	 * \brief Savoir si le flux est terminé.
+	 */
+	inline
+	bool
+	termine() const
+	{
+	    return termine_;
+	}
+
+	/**
+	 * \brief Raison de l'échec de la dernière lecture, vide si
+	 *        elle a réussi.
+	 */
+	inline
+	const std::string&
+	erreur() const
+	{
+	    return erreur_;
+	}
+
+	/**
+	 * \brief Nombre de parties lues ou sautées depuis le début du
+	 *        flux.
+	 */
+	inline
+	long
+	nbParties() const
+	{
+	    return nbParties_;
+	}
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	LecteurSgf(const LecteurSgf&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	LecteurSgf&
+	operator=(const LecteurSgf&);
+
+	/**
+	 * \brief Lecture d'une valeur entre crochets, recopiée dans
+	 *        valeur_ si elle doit être gardée.
+	 */
+	bool
+	lireValeur(bool garder);
+
+	/**
+	 * \brief Prise en compte d'une valeur d'une propriété de la
+	 *        ligne principale.
+	 */
+	bool
+	propriete(PartieSgf& partie);
+
+	/**
+	 * \brief Lecture d'une intersection notée par deux lettres,
+	 *        la colonne puis la ligne à partir du haut.
+	 */
+	static
+	bool
+	lirePoint(const char* texte, int taille, Intersection& inter);
+
+	/**
+	 * \brief Tampon du flux, lu caractère par caractère.
+	 */
+	std::streambuf* tampon_;
+
+	bool termine_;
+
+	std::string erreur_;
+
+	long nbParties_;
+
+	/**
+	 * \brief Propriété en cours de lecture, minuscules ôtées.
+	 */
+	std::string identifiant_;
+
+	/**
+	 * \brief Valeur en cours de lecture.
+	 */
+	std::string valeur_;
+
+	/**
+	 * \brief Savoir si le trait a été fixé par un coup ou par la
+	 *        propriété PL.
+	 */
+	bool traitConnu_;
+
+	/**
+	 * \brief Couleur du prochain coup attendu.
+	 */
+	bool tourNoir_;
+
+    };
+
+    /**
+     * \brief Écriture d'une partie au format SGF au fil du jeu.
+     *
+     * Chaque coup est écrit et le flux vidé dès qu'il est joué, si
+     * bien qu'une partie interrompue reste lisible jusqu'à son
+     * dernier coup une fois la parenthèse fermante ajoutée. Le
+     * résultat étant une information du nœud racine, il ne peut
+     * être donné qu'au début de la partie.
+     */
+    class EcrivainSgf {
+
+    public:
+
+	/**
+	 * \brief Constructeur d'écrivain sur un flux de sortie.
+	 */
+	explicit
+	EcrivainSgf(std::ostream& out);
+
+	/**
+	 * \brief Écriture du nœud racine d'une nouvelle partie.
+	 *
+	 * La partie précédente est terminée si elle ne l'était pas.
+	 */
+	void
+	debut(int taille, double komi,
+	      const std::string& joueurNoir = "",
+	      const std::string& joueurBlanc = "",
+	      const std::string& resultat = "");
+
+	/**
+	 * \brief Placement d'une pierre de départ, dans le nœud
+	 *        racine : il doit précéder le premier coup.
+	 */
+	void
+	placer(const Intersection& inter, bool noir);
+
+	/**
+	 * \brief Écriture d'un coup, pierre posée ou passe.
+	 */
+	void
+	coup(const Coup& coup, bool noir);
+
+	/**
+	 * \brief Fin de la partie en cours.
+	 */
+	void
+	fin();
+
+	/**
+	 * \brief Écriture d'une partie entière, d'après son
+	 *        historique.
+	 *
+	 * Les pierres de la position de départ de la partie sont
+	 * placées, puis les coups sont écrits avec la couleur de la
+	 * pierre posée, lue sur le goban : les pierres de handicap
+	 * posées par Partie::debut() sont des coups noirs consécutifs.
+	 */
+	void
+	ecrire(const Partie& partie, double komi,
+	       const std::string& resultat = "");
+
+    private:
+
+	/**
+	 * \brief Constructeur par copie non implémenté.
+	 */
+	EcrivainSgf(const EcrivainSgf&);
+
+	/**
+	 * \brief Opérateur de copie non implémenté.
+	 */
+	EcrivainSgf&
+	operator=(const EcrivainSgf&);
+
+	/**
+	 * \brief Écriture d'une intersection.
+	 */
+	void
+	point(const Intersection& inter);
+
+	/**
+	 * \brief Écriture d'un texte, crochets et barres obliques
+	 *        inverses protégés.
+	 */
+	void
+	texte(const std::string& texte);
+
+	std::ostream& out_;
+
+	int taille_;
+
+	/**
+	 * \brief Savoir si une partie est en cours.
+	 */
+	bool ouverte_;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef JEU_SYMETRIE_HPP
+#define JEU_SYMETRIE_HPP
+
+#include <algorithm> // std::swap
+
+#include <jeu/types.hpp> // jeu::Intersection, jeu::Coup
+
+namespace jeu {
+
+    /**
+     * \brief Classe représentant l'une des 8 symétries du goban.
+     *
+     * Une symétrie est codée sur trois bits : la transposition des
+     * lignes et des colonnes, appliquée en premier, puis le miroir
+     * des lignes et celui des colonnes. Le code 0 est l'identité.
+     */
+    class Symetrie {
+
+    public:
+
+	/**
+	 * \brief Nombre de symétries du goban.
+	 */
+	static const int NB = 8;
+
+	/**
+	 * \brief Bits du code d'une symétrie.
+	 */
+	enum {
+	    MIROIR_I = 1,
+	    MIROIR_J = 2,
+	    TRANSPOSITION = 4
+	};
+
+	/**
+	 * \brief Constructeur de symétrie à partir de son code, entre
+	 *        0 et NB - 1.
+	 */
+	explicit
+	Symetrie(int code = 0) :
+	    code_(code)
+	{
+	}
+
+	inline
+	int
+	code() const
+	{
+	    return code_;
+	}
+
+	/**
+	 * \brief Symétrie réciproque.
+	 *
+	 * Les miroirs seuls sont leurs propres réciproques ; après
+	 * une transposition, les deux miroirs échangent leurs rôles.
+	 */
+	inline
+	Symetrie
+	inverse() const
+	{
+	    if (!(code_ & TRANSPOSITION)) {
+		return *this;
+	    }
+	    return Symetrie(TRANSPOSITION
+			    | ((code_ & MIROIR_I) ? MIROIR_J : 0)
+			    | ((code_ & MIROIR_J) ? MIROIR_I : 0));
+	}
+
+	/**
+	 * \brief Image d'une intersection sur un goban de taille
+	 *        donnée.
+	 */
+	inline
+	Intersection
+	appliquer(const Intersection& inter, int taille) const
+	{
+	    Intersection image(inter);
+	    if (code_ & TRANSPOSITION) {
+		std::swap(image.i, image.j);
+	    }
+	    if (code_ & MIROIR_I) {
+		image.i = taille - 1 - image.i;
+	    }
+	    if (code_ & MIROIR_J) {
+		image.j = taille - 1 - image.j;
+	    }
+	    return image;
+	}
+
+	/**
+	 * \brief Image d'un coup sur un goban de taille donnée.
+	 *
+	 * Seuls les coups qui posent une pierre sont modifiés.
+	 */
+	inline
+	Coup
+	appliquer(const Coup& coup, int taille) const
+	{
+	    Coup image(coup);
+	    if (coup.type == TC_POSER) {
+		image.intersection = appliquer(coup.intersection, taille);
+	    }
+	    return image;
+	}
+
+    private:
+
+	int code_;
+
+    };
+
+}
+
+#endif
@@ -90,6 +90,9 @@ namespace jeu {
 
     /**
      * \brief Structure représentant un score dans le jeu.
+     *
+     * Les points sont comptés en demi-points, pour que le komi
+     * puisse en comporter un.
      */
     struct Score {
 
@@ -125,6 +128,15 @@ namespace jeu {
 	{
 	};
 
+	/**
+	 * \brief Constructeur de score par copie.
+	 */
+	Score(const Score& score) :
+	    noir(score.noir),
+	    blanc(score.blanc)
+	{
+	};
+
 	/**
 	 * \brief Opérateur de copie de score.
 	 */
@@ -195,6 +207,20 @@ namespace jeu {
 	};
     };
 
+    /**
+     * \brief Opérateur d'égalité de coups.
+     *
+     * L'intersection n'est comparée que pour les coups qui posent
+     * une pierre.
+     */
+    inline
+    bool
+    operator==(const Coup& c1, const Coup& c2)
+    {
+	return c1.type == c2.type &&
+	    (c1.type != TC_POSER || c1.intersection == c2.intersection);
+    }
+
 }
 
 #endif
@@ -64,10 +64,10 @@ main()
 
     const jeu::Score& score = partie.etatCourant().score();
     std::cout << "Score noir : "
-	      << score.noir
+	      << score.noir / 2.0
 	      << std::endl;
     std::cout << "Score blanc : "
-	      << score.blanc
+	      << score.blanc / 2.0
 	      << std::endl;
 
     affichage.attendre();
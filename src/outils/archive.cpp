@@ -0,0 +1,141 @@
+/**
+ * \file archive.cpp
+ * \brief Conversion de parties SGF en archive binaire, et
+ *        relecture d'une archive.
+ *
+ * Sans option, les parties d'une collection SGF lue sur l'entrée
+ * standard sont ajoutées à l'archive ; celles qui ne peuvent pas
+ * l'être sont comptées et ignorées.
+ *
+ * Avec l'option -l, toutes les parties de l'archive sont rejouées
+ * dans une jeu::Partie, superko compris, et le débit de la
+ * relecture est affiché.
+ *
+ * Usage : archive fichier < parties.sgf
+ *         archive -l fichier
+ */
+
+#include <cstdio> // std::printf, std::fprintf
+
+#include <chrono> // std::chrono
+#include <iostream> // std::cin
+#include <string> // std::string
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/joueur.hpp>
+#include <jeu/partie.hpp>
+#include <jeu/sgf.hpp>
+#include <jeu/archive.hpp>
+
+namespace {
+
+    int
+    convertir(const std::string& fichier)
+    {
+	jeu::EcrivainArchive archive;
+	if (!archive.ouvrir(fichier)) {
+	    std::fprintf(stderr, "impossible de créer %s\n", fichier.c_str());
+	    return 1;
+	}
+	std::ios::sync_with_stdio(false);
+	jeu::LecteurSgf lecteur(std::cin);
+	jeu::PartieSgf partie;
+	long nbIgnorees = 0;
+	long nbCoups = 0;
+	while (!lecteur.termine()) {
+	    if (lecteur.suivante(partie)) {
+		if (archive.ajouter(partie)) {
+		    nbCoups += partie.coups.size() + partie.noires.size();
+		}
+		else {
+		    ++nbIgnorees;
+		}
+	    }
+	    else if (!lecteur.erreur().empty()) {
+		std::fprintf(stderr, "partie %ld : %s\n", lecteur.nbParties(),
+			     lecteur.erreur().c_str());
+		++nbIgnorees;
+	    }
+	}
+	long nbParties = archive.nbParties();
+	if (!archive.fermer()) {
+	    std::fprintf(stderr, "impossible d'écrire %s\n", fichier.c_str());
+	    return 1;
+	}
+	std::printf("%ld parties, %ld ignorées, %ld coups\n",
+		    nbParties, nbIgnorees, nbCoups);
+
+	// place occupée par les coups, en-têtes non compris
+	jeu::Archive resultat;
+	if (resultat.ouvrir(fichier) && nbCoups > 0) {
+	    long nbOctets = 0;
+	    for (long n = 0; n < resultat.nbParties(); ++n) {
+		const uint8_t* fin;
+		const uint8_t* coups = resultat.coups(n, fin);
+		nbOctets += fin - coups;
+	    }
+	    std::printf("octets_par_coup %.3f\n", (double) nbOctets / nbCoups);
+	}
+	return 0;
+    }
+
+    int
+    relire(const std::string& fichier)
+    {
+	jeu::Archive archive;
+	if (!archive.ouvrir(fichier)) {
+	    std::fprintf(stderr, "archive illisible : %s\n", fichier.c_str());
+	    return 1;
+	}
+
+	jeu::Spectateur spectateur;
+	jeu::Relecture relecture(archive);
+	long nbCoups = 0;
+	long nbIllicites = 0;
+	std::chrono::steady_clock::time_point debut =
+	    std::chrono::steady_clock::now();
+	for (long n = 0; n < archive.nbParties(); ++n) {
+	    if (!relecture.commencer(n)) {
+		++nbIllicites;
+		continue;
+	    }
+	    jeu::Partie partie(relecture.etat(), relecture.tourNoir(),
+			       spectateur, spectateur);
+	    jeu::Coup coup;
+	    bool licite = true;
+	    while (licite && relecture.suivant(coup)) {
+		licite = partie.jouer(coup);
+		++nbCoups;
+	    }
+	    if (!licite || relecture.nbCoups() != relecture.enTete().nbCoups) {
+		++nbIllicites;
+	    }
+	}
+	std::chrono::duration<double> duree =
+	    std::chrono::steady_clock::now() - debut;
+
+	std::printf("%ld parties, %ld illicites, %ld coups\n",
+		    archive.nbParties(), nbIllicites, nbCoups);
+	std::printf("parties_par_seconde %.1f\n",
+		    archive.nbParties() / duree.count());
+	std::printf("coups_par_seconde %.1f\n", nbCoups / duree.count());
+	return nbIllicites > 0 ? 1 : 0;
+    }
+
+}
+
+int
+main(int argc, char** argv)
+{
+    if (argc == 2 && std::string(argv[1]) != "-l") {
+	return convertir(argv[1]);
+    }
+    if (argc == 3 && std::string(argv[1]) == "-l") {
+	return relire(argv[2]);
+    }
+    std::fprintf(stderr, "usage : %s fichier < parties.sgf\n"
+		 "        %s -l fichier\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,145 @@
+/**
+ * \file bibliotheque.cpp
+ * \brief Construction d'une bibliothèque d'ouvertures à partir
+ *        de parties enregistrées.
+ *
+ * Les parties sont lues sur l'entrée standard, une par ligne :
+ * la taille du goban suivie des coups, notés comme pour
+ * jeu::JoueurTexte (C3 pour la colonne C et la ligne 3, p pour
+ * passer). Les lignes vides et celles qui commencent par # sont
+ * ignorées.
+ *
+ * Chaque position atteinte dans les premiers coups d'une partie
+ * donne une entrée pour le coup qui y a été joué, de poids égal
+ * au nombre de parties où il l'a été, à une symétrie près. Les
+ * coups joués moins souvent que le minimum sont écartés. Une
+ * partie qui contient un coup illisible ou illicite n'est prise
+ * en compte que jusqu'à ce coup.
+ *
+ * Usage : bibliotheque sortie [taille [profondeur [minimum]]]
+ */
+
+#include <cstdio> // std::printf, std::fprintf
+#include <cstdlib> // std::atoi
+
+#include <iostream> // std::cin
+#include <sstream> // std::istringstream
+#include <string> // std::string
+#include <vector> // std::vector
+#include <map> // std::map
+#include <utility> // std::pair
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/bitboard.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/symetrie.hpp>
+
+#include <ia/bibliotheque.hpp>
+
+namespace {
+
+    /**
+     * \brief Lecture d'un coup noté comme pour jeu::JoueurTexte.
+     */
+    bool
+    lireCoup(const std::string& mot, int taille, jeu::Coup& coup)
+    {
+	if (mot == "p") {
+	    coup.type = jeu::TC_PASSER;
+	    return true;
+	}
+	std::istringstream flux(mot);
+	char c;
+	int i;
+	char reste;
+	if (!(flux >> c >> i) || (flux >> reste) ||
+	    c < 'A' || c - 'A' >= taille || i < 1 || i > taille) {
+	    return false;
+	}
+	coup = jeu::Coup(jeu::Intersection(i - 1, c - 'A'));
+	return true;
+    }
+
+}
+
+int
+main(int argc, char** argv)
+{
+    if (argc < 2) {
+	std::fprintf(stderr,
+		     "usage : %s sortie [taille [profondeur [minimum]]]\n",
+		     argv[0]);
+	return 1;
+    }
+    std::string sortie = argv[1];
+    int taille = argc > 2 ? std::atoi(argv[2]) : 9;
+    int profondeur = argc > 3 ? std::atoi(argv[3]) : 20;
+    int minimum = argc > 4 ? std::atoi(argv[4]) : 2;
+    if (taille < 2 || taille > jeu::Bitboard::TAILLE_MAX) {
+	std::fprintf(stderr, "taille invalide, de 2 à %d\n",
+		     jeu::Bitboard::TAILLE_MAX);
+	return 1;
+    }
+
+    jeu::Goban goban(taille);
+
+    // nombre de parties par position et par coup
+    std::map<std::pair<uint64_t, uint16_t>, uint32_t> occurrences;
+
+    int nbParties = 0;
+    std::string ligne;
+    while (std::getline(std::cin, ligne)) {
+	std::istringstream flux(ligne);
+	int tailleLigne;
+	if (ligne.empty() || ligne[0] == '#' || !(flux >> tailleLigne)) {
+	    continue;
+	}
+	if (tailleLigne != taille) {
+	    continue;
+	}
+	++nbParties;
+
+	jeu::EtatGoban etat(goban);
+	bool tourNoir = true;
+	std::string mot;
+	for (int n = 0; n < profondeur && flux >> mot; ++n) {
+	    jeu::Coup coup;
+	    if (!lireCoup(mot, taille, coup)) {
+		break;
+	    }
+	    jeu::Symetrie symetrie;
+	    uint64_t position = ia::Bibliotheque::cle(etat, tourNoir, symetrie);
+	    std::pair<uint64_t, uint16_t> cle(
+		position,
+		ia::Bibliotheque::coder(symetrie.appliquer(coup, taille), taille));
+	    if (coup.type == jeu::TC_POSER &&
+		!etat.poser(coup.intersection, tourNoir)) {
+		break;
+	    }
+	    ++occurrences[cle];
+	    tourNoir = !tourNoir;
+	}
+    }
+
+    std::vector<ia::Bibliotheque::Entree> entrees;
+    std::map<std::pair<uint64_t, uint16_t>, uint32_t>::const_iterator it;
+    for (it = occurrences.begin(); it != occurrences.end(); ++it) {
+	if (it->second >= (uint32_t) minimum) {
+	    ia::Bibliotheque::Entree entree;
+	    entree.cle = it->first.first;
+	    entree.coup = it->first.second;
+	    entree.reserve = 0;
+	    entree.poids = it->second;
+	    entrees.push_back(entree);
+	}
+    }
+
+    if (!ia::Bibliotheque::ecrire(sortie, taille, entrees)) {
+	std::fprintf(stderr, "impossible d'écrire %s\n", sortie.c_str());
+	return 1;
+    }
+    std::printf("%d parties, %d entrées\n",
+		nbParties, (int) entrees.size());
+    return 0;
+}
@@ -0,0 +1,323 @@
+/**
+ * \file tournoi.cpp
+ * \brief Tournoi entre deux joueurs, sans interface graphique.
+ *
+ * Les parties sont réparties entre plusieurs threads, chacun
+ * jouant une partie à la fois avec ses propres joueurs. Le
+ * joueur A a les noirs dans les parties paires et les blancs dans
+ * les parties impaires ; chaque partie a sa propre graine, tirée
+ * de son numéro, si bien qu'un tournoi peut être rejoué.
+ *
+ * Une partie est gagnée d'après le décompte par surface. Le taux
+ * de victoire de A est donné avec son intervalle de confiance à
+ * 95 % (intervalle de Wilson), une égalité comptant pour une
+ * demi-victoire.
+ *
+ * Un joueur est décrit par « aleatoire » ou par « ia » suivi
+ * éventuellement de paramètres : ia:simulations=1000,rave=0. Les
+ * paramètres reconnus sont simulations, threads, rave,
+ * heuristiques, exploration (avec ou sans RAVE), reflexion,
+ * noeuds, transpositions (en Mo) et bibliotheque. Par défaut,
+ * chaque joueur intelligent utilise un seul thread, ne réfléchit
+ * pas pendant le tour de l'adversaire, et se contente d'un arbre
+ * et d'une table de transposition à la mesure de son nombre de
+ * simulations.
+ *
+ * Usage : tournoi joueurA joueurB [parties [taille [threads [komi]]]]
+ */
+
+#include <cmath> // std::sqrt, std::floor
+#include <cstdio> // std::printf, std::fprintf
+#include <cstdlib> // std::atoi, std::atof
+
+#include <algorithm> // std::min, std::max
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono
+#include <mutex> // std::mutex
+#include <sstream> // std::istringstream
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <jeu/types.hpp>
+#include <jeu/goban.hpp>
+#include <jeu/bitboard.hpp>
+#include <jeu/etatgoban.hpp>
+#include <jeu/joueur.hpp>
+#include <jeu/partie.hpp>
+
+#include <ia/recherche.hpp>
+#include <ia/joueur.hpp>
+
+namespace {
+
+    /**
+     * \brief Description d'un joueur du tournoi.
+     */
+    struct Description {
+	bool intelligent;
+	ia::Parametres parametres;
+	std::string bibliotheque;
+    };
+
+    /**
+     * \brief Lecture de la description d'un joueur.
+     */
+    bool
+    decrire(const std::string& texte, Description& description)
+    {
+	description.intelligent = false;
+	if (texte == "aleatoire") {
+	    return true;
+	}
+	if (texte.compare(0, 2, "ia") != 0 ||
+	    (texte.size() > 2 && texte[2] != ':')) {
+	    return false;
+	}
+
+	description.intelligent = true;
+	ia::Parametres& parametres = description.parametres;
+	parametres.nbThreads = 1;
+	parametres.reflexion = false;
+	parametres.messages = false;
+	int noeuds = 0;
+	int transpositions = -1;
+
+	std::istringstream flux(texte.size() > 3 ? texte.substr(3) : "");
+	std::string reglage;
+	while (std::getline(flux, reglage, ',')) {
+	    std::string::size_type egal = reglage.find('=');
+	    if (egal == std::string::npos) {
+		return false;
+	    }
+	    std::string cle = reglage.substr(0, egal);
+	    std::string valeur = reglage.substr(egal + 1);
+	    if (cle == "simulations") {
+		parametres.nbSimulations = std::atoi(valeur.c_str());
+	    }
+	    else if (cle == "threads") {
+		parametres.nbThreads = std::max(std::atoi(valeur.c_str()), 1);
+	    }
+	    else if (cle == "rave") {
+		parametres.rave = std::atoi(valeur.c_str()) != 0;
+	    }
+	    else if (cle == "heuristiques") {
+		parametres.heuristiques = std::atoi(valeur.c_str()) != 0;
+	    }
+	    else if (cle == "exploration") {
+		parametres.exploration = std::atof(valeur.c_str());
+		parametres.explorationRave = parametres.exploration;
+	    }
+	    else if (cle == "reflexion") {
+		parametres.reflexion = std::atoi(valeur.c_str()) != 0;
+	    }
+	    else if (cle == "noeuds") {
+		noeuds = std::atoi(valeur.c_str());
+	    }
+	    else if (cle == "transpositions") {
+		transpositions = std::atoi(valeur.c_str());
+	    }
+	    else if (cle == "bibliotheque") {
+		description.bibliotheque = valeur;
+	    }
+	    else {
+		return false;
+	    }
+	}
+
+	// un arbre par défaut pour chaque joueur de chaque thread
+	// occuperait vite toute la mémoire
+	int simulations = parametres.nbSimulations
+	    + (parametres.reflexion ? parametres.nbSimulationsReflexion : 0);
+	parametres.capaciteArbre = noeuds > 0 ? noeuds
+	    : std::min(parametres.capaciteArbre, 128 * simulations);
+	parametres.tailleTranspositions = transpositions >= 0
+	    ? transpositions
+	    : std::min(parametres.tailleTranspositions, 8);
+	return true;
+    }
+
+    /**
+     * \brief Création d'un joueur d'après sa description.
+     */
+    jeu::Joueur*
+    creer(const Description& description, uint64_t graine)
+    {
+	if (!description.intelligent) {
+	    return new jeu::JoueurAleatoire(graine);
+	}
+	ia::JoueurIntelligent* joueur =
+	    new ia::JoueurIntelligent(description.parametres, graine);
+	if (!description.bibliotheque.empty()) {
+	    joueur->ouvrirBibliotheque(description.bibliotheque);
+	}
+	return joueur;
+    }
+
+    /**
+     * \brief Résultats cumulés du tournoi, du point de vue de A.
+     */
+    struct Resultats {
+	int parties;
+	int victoires;
+	int egalites;
+	int victoiresNoir;
+	int partiesNoir;
+	long coups;
+    };
+
+    /**
+     * \brief Intervalle de confiance de Wilson à 95 % d'une
+     *        proportion.
+     */
+    void
+    wilson(double p, int n, double& bas, double& haut)
+    {
+	const double z = 1.96;
+	if (n == 0) {
+	    bas = 0;
+	    haut = 1;
+	    return;
+	}
+	double centre = (p + z * z / (2 * n)) / (1 + z * z / n);
+	double marge = z * std::sqrt(p * (1 - p) / n + z * z / (4.0 * n * n))
+	    / (1 + z * z / n);
+	bas = centre - marge;
+	haut = centre + marge;
+    }
+
+    /**
+     * \brief Boucle d'un thread : parties jouées jusqu'à ce qu'il
+     *        n'en reste plus.
+     */
+    void
+    jouerParties(const Description& a, const Description& b,
+		 int nbParties, int taille, int demiKomi,
+		 std::atomic<int>& prochaine, Resultats& resultats,
+		 std::mutex& verrou)
+    {
+	jeu::Goban goban(taille, demiKomi);
+	for (int p = prochaine++; p < nbParties; p = prochaine++) {
+	    bool aNoir = p % 2 == 0;
+	    uint64_t graine = 2 * (uint64_t) p + 1;
+	    jeu::Joueur* joueurA = creer(a, graine * 0x9e3779b97f4a7c15ULL);
+	    jeu::Joueur* joueurB = creer(b, graine * 0xbf58476d1ce4e5b9ULL);
+
+	    jeu::Partie partie(goban, aNoir ? *joueurA : *joueurB,
+			       aNoir ? *joueurB : *joueurA);
+	    partie.debut();
+	    int nbToursMax = 3 * taille * taille;
+	    for (int t = 0; t < nbToursMax && !partie.finie(); ++t) {
+		partie.tourSuivant();
+	    }
+	    jeu::Score score = partie.etatCourant().scoreSurface();
+	    int ecart = score.noir - score.blanc;
+	    int coups = partie.historique().size();
+
+	    delete joueurA;
+	    delete joueurB;
+
+	    std::lock_guard<std::mutex> garde(verrou);
+	    ++resultats.parties;
+	    resultats.coups += coups;
+	    if (aNoir) {
+		++resultats.partiesNoir;
+	    }
+	    if (ecart == 0) {
+		++resultats.egalites;
+	    }
+	    else if ((ecart > 0) == aNoir) {
+		++resultats.victoires;
+		if (aNoir) {
+		    ++resultats.victoiresNoir;
+		}
+	    }
+	    if (resultats.parties % 10 == 0) {
+		std::fprintf(stderr,
+			     "%d/%d parties, A %d, B %d, %d égalités\n",
+			     resultats.parties, nbParties, resultats.victoires,
+			     resultats.parties - resultats.victoires
+			     - resultats.egalites, resultats.egalites);
+	    }
+	}
+    }
+
+}
+
+int
+main(int argc, char** argv)
+{
+    if (argc < 3) {
+	std::fprintf(stderr, "usage : %s joueurA joueurB "
+		     "[parties [taille [threads [komi]]]]\n", argv[0]);
+	return 1;
+    }
+    Description a;
+    Description b;
+    if (!decrire(argv[1], a) || !decrire(argv[2], b)) {
+	std::fprintf(stderr, "joueur inconnu\n");
+	return 1;
+    }
+    int nbParties = argc > 3 ? std::atoi(argv[3]) : 100;
+    int taille = argc > 4 ? std::atoi(argv[4]) : 9;
+    int nbThreads = argc > 5 ? std::atoi(argv[5])
+	: (int) std::thread::hardware_concurrency();
+    double komi = argc > 6 ? std::atof(argv[6]) : 7;
+    int demiKomi = (int) std::floor(2 * komi + 0.5);
+    if (nbParties < 1 || taille < 2 || taille > jeu::Bitboard::TAILLE_MAX ||
+	(argc > 5 && nbThreads < 1)) {
+	std::fprintf(stderr, "usage : %s joueurA joueurB "
+		     "[parties [taille [threads [komi]]]]\n"
+		     "parties et threads positifs, taille de 2 à %d\n",
+		     argv[0], jeu::Bitboard::TAILLE_MAX);
+	return 1;
+    }
+    nbThreads = std::max(std::min(nbThreads, nbParties), 1);
+
+    Resultats resultats = Resultats();
+    std::atomic<int> prochaine(0);
+    std::mutex verrou;
+
+    std::chrono::steady_clock::time_point debut =
+	std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbThreads; ++t) {
+	threads.push_back(std::thread(jouerParties, std::cref(a),
+				      std::cref(b), nbParties, taille, demiKomi,
+				      std::ref(prochaine), std::ref(resultats),
+				      std::ref(verrou)));
+    }
+    for (int t = 0; t < nbThreads; ++t) {
+	threads[t].join();
+    }
+    std::chrono::duration<double> duree =
+	std::chrono::steady_clock::now() - debut;
+
+    int n = resultats.parties;
+    double score = n > 0
+	? (resultats.victoires + 0.5 * resultats.egalites) / n : 0;
+    double bas;
+    double haut;
+    wilson(score, n, bas, haut);
+    int partiesBlanc = n - resultats.partiesNoir;
+
+    std::printf("# %s contre %s, goban %dx%d, komi %g, %d threads\n",
+		argv[1], argv[2], taille, taille, demiKomi / 2.0, nbThreads);
+    std::printf("parties %d\n", n);
+    std::printf("victoires %d defaites %d egalites %d\n",
+		resultats.victoires,
+		n - resultats.victoires - resultats.egalites,
+		resultats.egalites);
+    std::printf("taux %.3f intervalle %.3f %.3f\n", score, bas, haut);
+    std::printf("taux_noir %.3f taux_blanc %.3f\n",
+		resultats.partiesNoir > 0
+		? (double) resultats.victoiresNoir / resultats.partiesNoir : 0,
+		partiesBlanc > 0
+		? (double) (resultats.victoires - resultats.victoiresNoir)
+		/ partiesBlanc : 0);
+    std::printf("coups_par_partie %.1f\n",
+		n > 0 ? (double) resultats.coups / n : 0);
+    std::printf("coups_par_seconde %.1f\n", resultats.coups / duree.count());
+    std::printf("duree %.1f\n", duree.count());
+    return 0;
+}